@@ -0,0 +1,80 @@
+/**
+ * @file AliasTable.hpp
+ * @brief Walker/Vose alias table for O(1) sampling from a fixed discrete distribution.
+ */
+
+#ifndef ALIAS_TABLE_HPP
+#define ALIAS_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @class AliasTable
+ * @brief Samples index k with probability weights[k] / sum(weights) in constant time.
+ *
+ * Building the table is O(K): every slot holds its own index with probability prob[k] and an
+ * alias otherwise, so a draw is one uniform slot plus one uniform coin (Vose's method).
+ */
+class AliasTable {
+private:
+    std::vector<double> _prob;         /** <Probability of keeping the slot's own index */
+    std::vector<std::uint32_t> _alias; /** <Index returned when the slot is not kept */
+
+public:
+    AliasTable() = default;
+
+    /**
+     * @brief Builds the table.
+     * @param weights Non-negative weights with a positive sum.
+     */
+    explicit AliasTable(const std::vector<double>& weights) {
+        const std::size_t K = weights.size();
+        double total = 0.0;
+        for (double w : weights) {
+            if (!(w >= 0.0)) throw std::invalid_argument("AliasTable: weights must be non-negative");
+            total += w;
+        }
+        if (!(total > 0.0)) throw std::invalid_argument("AliasTable: weights must have a positive sum");
+
+        _prob.resize(K);
+        _alias.resize(K);
+        std::vector<double> scaled(K);
+        std::vector<std::uint32_t> small, large;
+        for (std::size_t k = 0; k < K; ++k) {
+            scaled[k] = weights[k] * K / total;
+            (scaled[k] < 1.0 ? small : large).push_back(static_cast<std::uint32_t>(k));
+        }
+        while (!small.empty() && !large.empty()) {
+            std::uint32_t s = small.back(); small.pop_back();
+            std::uint32_t l = large.back(); large.pop_back();
+            _prob[s] = scaled[s];
+            _alias[s] = l;
+            scaled[l] -= 1.0 - scaled[s];
+            (scaled[l] < 1.0 ? small : large).push_back(l);
+        }
+        //whatever is left is 1 up to rounding
+        for (std::uint32_t k : large) { _prob[k] = 1.0; _alias[k] = k; }
+        for (std::uint32_t k : small) { _prob[k] = 1.0; _alias[k] = k; }
+    }
+
+    std::size_t size() const { return _prob.size(); }
+    bool empty() const { return _prob.empty(); }
+
+    /**
+     * @brief Draws one index.
+     * @param gen Uniform random bit generator.
+     */
+    template <class Gen>
+    std::size_t sample(Gen& gen) const {
+        std::uniform_int_distribution<std::size_t> slot(0, _prob.size() - 1);
+        std::uniform_real_distribution<double> coin(0.0, 1.0);
+        std::size_t k = slot(gen);
+        return coin(gen) < _prob[k] ? k : _alias[k];
+    }
+};
+
+#endif // ALIAS_TABLE_HPP
@@ -0,0 +1,41 @@
+/**
+ * @file Boundary.hpp
+ * @brief Boundary conditions of the grid and the index mapping used to fill halo cells.
+ */
+
+#ifndef BOUNDARY_HPP
+#define BOUNDARY_HPP
+
+/**
+ * @brief What lies beyond the edge of the grid.
+ *
+ * A reflecting edge mirrors the grid about the edge cell without repeating it, so an edge
+ * cell's outside neighbor is its inside neighbor: an edge cell next to one infected cell has
+ * two infected neighbors, where a closed edge gives it one.
+ */
+enum class Boundary {
+    Closed,     /** <Nothing: cells past the edge are never infected (the original model) */
+    Periodic,   /** <The grid wraps around into a torus */
+    Reflecting  /** <The grid is mirrored about its edge cells: cell -1 is cell 1, -2 is 2, n is n - 2, ... */
+};
+
+/**
+ * @brief Maps a row or column index outside [0, n) back into the grid.
+ * @param k Index, possibly negative or >= n.
+ * @param n Grid side length.
+ * @param b Periodic or Reflecting (Closed has no image; callers handle it separately).
+ * @return The index in [0, n) whose cell the halo cell copies.
+ */
+inline int boundaryIndex(int k, int n, Boundary b) {
+    if (b == Boundary::Periodic) {
+        int m = k % n;
+        return m < 0 ? m + n : m;
+    }
+    if (n == 1) return 0;
+    int period = 2 * (n - 1);
+    int m = k % period;
+    if (m < 0) m += period;
+    return m < n ? m : period - m;
+}
+
+#endif // BOUNDARY_HPP
@@ -0,0 +1,59 @@
+/**
+ * @file CellState.hpp
+ * @brief Compact one-byte encoding of the four epidemiological states.
+ */
+
+#ifndef CELL_STATE_HPP
+#define CELL_STATE_HPP
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief One-byte code for a Person's state, used by the byte-plane kernels.
+ *
+ * The numeric values are stable: they are stored in files and used to index count arrays.
+ */
+enum class CellState : std::uint8_t {
+    Susceptible = 0,
+    Infected    = 1,
+    Recovered   = 2,
+    Vaccinated  = 3
+};
+
+/**
+ * @brief Converts a state string ("susceptible", "infected", ...) to its code.
+ * @param s State string as returned by Person::getState().
+ * @return The matching code; unknown strings map to Susceptible.
+ */
+inline CellState cellStateFromString(const std::string& s) {
+    if (s == "infected")   return CellState::Infected;
+    if (s == "recovered")  return CellState::Recovered;
+    if (s == "vaccinated") return CellState::Vaccinated;
+    return CellState::Susceptible;
+}
+
+/**
+ * @brief Converts a code back to the state string Person uses.
+ * @param c State code.
+ * @return "susceptible", "infected", "recovered" or "vaccinated".
+ */
+inline const char* cellStateName(CellState c) {
+    switch (c) {
+        case CellState::Infected:   return "infected";
+        case CellState::Recovered:  return "recovered";
+        case CellState::Vaccinated: return "vaccinated";
+        default:                    return "susceptible";
+    }
+}
+
+/**
+ * @brief A cell changing state, as recorded by Population for incremental consumers.
+ */
+struct CellTransition {
+    std::int32_t cell; /** <Row-major cell index */
+    CellState    from;
+    CellState    to;
+};
+
+#endif // CELL_STATE_HPP
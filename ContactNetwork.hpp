@@ -0,0 +1,350 @@
+/**
+ * @file ContactNetwork.hpp
+ * @brief Contact-network population: S/I/R/V dynamics on a graph stored in compressed sparse row form.
+ */
+
+#ifndef CONTACT_NETWORK_HPP
+#define CONTACT_NETWORK_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "CellState.hpp"
+#include "CounterRng.hpp"
+#include "PhaseTimer.hpp"
+#include "SirvRules.hpp"
+
+/**
+ * @class ContactGraph
+ * @brief Undirected contact graph in compressed sparse row (CSR) form.
+ *
+ * The neighbors of vertex v are adjacency()[offsets()[v] .. offsets()[v+1]), sorted and free
+ * of duplicates and self loops, so a sweep over the vertices reads both arrays linearly.
+ * Vertex ids are 32-bit and edge offsets 64-bit.
+ */
+class ContactGraph {
+public:
+    using Edge = std::pair<std::int32_t, std::int32_t>;
+
+private:
+    std::vector<std::int64_t> _offsets{0}; /** <n + 1 offsets into _adj */
+    std::vector<std::int32_t> _adj;        /** <Concatenated neighbor lists */
+
+public:
+    ContactGraph() = default;
+
+    /**
+     * @brief Builds the graph from an edge list; each edge is stored in both directions.
+     * @param n Number of vertices; edge endpoints must be in [0, n).
+     * @param edges Edges; duplicates and self loops are dropped.
+     */
+    static ContactGraph fromEdges(std::int32_t n, const std::vector<Edge>& edges) {
+        if (n < 0) throw std::invalid_argument("ContactGraph: negative vertex count");
+        ContactGraph g;
+        std::vector<std::int64_t> degree(static_cast<std::size_t>(n) + 1, 0);
+        for (const Edge& e : edges) {
+            if (e.first < 0 || e.first >= n || e.second < 0 || e.second >= n) {
+                throw std::invalid_argument("ContactGraph: edge endpoint out of range");
+            }
+            if (e.first == e.second) continue;
+            ++degree[e.first + 1];
+            ++degree[e.second + 1];
+        }
+        for (std::int32_t v = 0; v < n; ++v) degree[v + 1] += degree[v];
+        std::vector<std::int32_t> adj(static_cast<std::size_t>(degree[n]));
+        std::vector<std::int64_t> fill(degree.begin(), degree.end() - 1);
+        for (const Edge& e : edges) {
+            if (e.first == e.second) continue;
+            adj[fill[e.first]++] = e.second;
+            adj[fill[e.second]++] = e.first;
+        }
+
+        //sort and deduplicate each list, compacting in place
+        g._offsets.assign(static_cast<std::size_t>(n) + 1, 0);
+        std::int64_t out = 0;
+        for (std::int32_t v = 0; v < n; ++v) {
+            auto first = adj.begin() + degree[v], last = adj.begin() + degree[v + 1];
+            std::sort(first, last);
+            last = std::unique(first, last);
+            out = std::copy(first, last, adj.begin() + out) - adj.begin();
+            g._offsets[v + 1] = out;
+        }
+        adj.resize(static_cast<std::size_t>(out));
+        adj.shrink_to_fit();
+        g._adj = std::move(adj);
+        return g;
+    }
+
+    /**
+     * @brief Loads a whitespace-separated edge list, one "u v" pair per line.
+     *
+     * Vertices are the integers 0 .. max id; blank lines and lines starting with '#' or '%'
+     * (SNAP and Matrix Market style comments) are skipped, and anything after the first two
+     * fields of a line is ignored.
+     * @param path Edge list file.
+     */
+    static ContactGraph loadEdgeList(const std::string& path) {
+        std::ifstream in(path);
+        if (!in) throw std::runtime_error("ContactGraph: cannot open '" + path + "'");
+        std::vector<Edge> edges;
+        std::int64_t maxId = -1;
+        std::string line;
+        std::size_t lineNo = 0;
+        while (std::getline(in, line)) {
+            ++lineNo;
+            const char* p = line.c_str();
+            while (*p == ' ' || *p == '\t') ++p;
+            if (*p == '\0' || *p == '\r' || *p == '#' || *p == '%') continue;
+            char* end = nullptr;
+            long long u = std::strtoll(p, &end, 10);
+            const char* q = end;
+            long long v = std::strtoll(q, &end, 10);
+            if (q == p || end == q || u < 0 || v < 0 || u > INT32_MAX - 1 || v > INT32_MAX - 1) {
+                throw std::runtime_error("ContactGraph: '" + path + "' line " + std::to_string(lineNo) +
+                                         ": expected two vertex ids");
+            }
+            edges.emplace_back(static_cast<std::int32_t>(u), static_cast<std::int32_t>(v));
+            maxId = std::max<std::int64_t>(maxId, std::max(u, v));
+        }
+        return fromEdges(static_cast<std::int32_t>(maxId + 1), edges);
+    }
+
+    std::int32_t vertexCount() const { return static_cast<std::int32_t>(_offsets.size() - 1); }
+    std::int64_t edgeCount() const { return static_cast<std::int64_t>(_adj.size()) / 2; }
+    std::int64_t degree(std::int32_t v) const { return _offsets[v + 1] - _offsets[v]; }
+    const std::vector<std::int64_t>& offsets() const { return _offsets; }
+    const std::vector<std::int32_t>& adjacency() const { return _adj; }
+
+    /**
+     * @brief Largest |u - v| over all edges: how far apart in memory a vertex's neighbors can be.
+     */
+    std::int64_t bandwidth() const {
+        std::int64_t b = 0;
+        for (std::int32_t v = 0; v < vertexCount(); ++v) {
+            for (std::int64_t k = _offsets[v]; k < _offsets[v + 1]; ++k) {
+                b = std::max<std::int64_t>(b, std::abs(static_cast<std::int64_t>(_adj[k]) - v));
+            }
+        }
+        return b;
+    }
+
+    /**
+     * @brief Reverse Cuthill-McKee ordering, which clusters each vertex's neighbors near it.
+     *
+     * Each connected component is walked breadth-first from a vertex of minimum degree,
+     * visiting neighbors by increasing degree, and the whole order is then reversed.
+     * @return order[k] is the vertex placed at position k.
+     */
+    std::vector<std::int32_t> reverseCuthillMcKee() const {
+        const std::int32_t n = vertexCount();
+        std::vector<std::int32_t> byDegree(n);
+        for (std::int32_t v = 0; v < n; ++v) byDegree[v] = v;
+        std::stable_sort(byDegree.begin(), byDegree.end(),
+                         [&](std::int32_t a, std::int32_t b) { return degree(a) < degree(b); });
+
+        std::vector<std::int32_t> order;
+        order.reserve(n);
+        std::vector<char> seen(n, 0);
+        std::vector<std::int32_t> next;
+        for (std::int32_t root : byDegree) {
+            if (seen[root]) continue;
+            seen[root] = 1;
+            std::size_t head = order.size();
+            order.push_back(root);
+            while (head < order.size()) {
+                const std::int32_t v = order[head++];
+                next.clear();
+                for (std::int64_t k = _offsets[v]; k < _offsets[v + 1]; ++k) {
+                    if (!seen[_adj[k]]) {
+                        seen[_adj[k]] = 1;
+                        next.push_back(_adj[k]);
+                    }
+                }
+                std::sort(next.begin(), next.end(),
+                          [&](std::int32_t a, std::int32_t b) { return degree(a) < degree(b); });
+                order.insert(order.end(), next.begin(), next.end());
+            }
+        }
+        std::reverse(order.begin(), order.end());
+        return order;
+    }
+
+    /**
+     * @brief The same graph with vertex order[k] renamed to k.
+     * @param order A permutation of the vertices, e.g. from reverseCuthillMcKee().
+     */
+    ContactGraph relabeled(const std::vector<std::int32_t>& order) const {
+        const std::int32_t n = vertexCount();
+        if (static_cast<std::int32_t>(order.size()) != n) {
+            throw std::invalid_argument("ContactGraph::relabeled: order is not a permutation");
+        }
+        std::vector<std::int32_t> position(n);
+        for (std::int32_t k = 0; k < n; ++k) position[order[k]] = k;
+        ContactGraph g;
+        g._offsets.assign(static_cast<std::size_t>(n) + 1, 0);
+        g._adj.resize(_adj.size());
+        for (std::int32_t k = 0; k < n; ++k) {
+            const std::int32_t v = order[k];
+            std::int64_t out = g._offsets[k];
+            for (std::int64_t e = _offsets[v]; e < _offsets[v + 1]; ++e) g._adj[out++] = position[_adj[e]];
+            std::sort(g._adj.begin() + g._offsets[k], g._adj.begin() + out);
+            g._offsets[k + 1] = out;
+        }
+        return g;
+    }
+};
+
+/**
+ * @class NetworkPopulation
+ * @brief One person per vertex of a ContactGraph, evolving under the same S/I/R/V rules as
+ *        Population, with neighbors given by the graph instead of the grid.
+ *
+ * States are one CellState byte per vertex in two buffers (read one, write the other), and
+ * every vertex draws its uniform from counterUniform(seed, day, vertex id). A step is
+ * therefore independent of traversal order: it runs in parallel over the vertices when built
+ * with OpenMP, and renumbering the vertices for locality (reverse Cuthill-McKee, on by
+ * default) changes the memory layout but not the result. Vertex ids in the public interface
+ * are always those of the graph passed in.
+ */
+class NetworkPopulation {
+public:
+    /**
+     * @brief Aggregate counts of each state.
+     */
+    struct Counts {
+    std::int64_t susceptible = 0;
+    std::int64_t infected = 0;
+    std::int64_t recovered = 0;
+    std::int64_t vaccinated = 0;
+    };
+
+private:
+    ContactGraph _g;                    /** <The graph in internal (possibly reordered) numbering */
+    std::vector<std::int32_t> _id;      /** <Original id of each internal vertex */
+    std::vector<std::int32_t> _index;   /** <Internal index of each original id */
+    std::vector<std::uint8_t> _state;   /** <CellState code per internal vertex */
+    std::vector<std::uint8_t> _next;    /** <Write buffer of step() */
+    std::uint64_t _seed;
+    SirvRates _rates;
+    int _t = 0;                         /** <Days elapsed */
+    Counts _counts;                     /** <Counts of _state, kept current */
+
+    std::int64_t& countOf(std::uint8_t code) {
+        switch (static_cast<CellState>(code)) {
+            case CellState::Susceptible: return _counts.susceptible;
+            case CellState::Infected:    return _counts.infected;
+            case CellState::Recovered:   return _counts.recovered;
+            default:                     return _counts.vaccinated;
+        }
+    }
+
+public:
+    /**
+     * @brief Creates an all-susceptible population on the given graph.
+     * @param g Contact graph.
+     * @param seed Seed of the per-vertex draws.
+     * @param rates Model rates.
+     * @param reorder Renumber vertices with reverse Cuthill-McKee for locality.
+     */
+    NetworkPopulation(const ContactGraph& g, std::uint64_t seed,
+                      const SirvRates& rates = SirvRates{}, bool reorder = true)
+    : _seed(seed), _rates(rates) {
+        const std::int32_t n = g.vertexCount();
+        if (reorder) {
+            _id = g.reverseCuthillMcKee();
+            _g = g.relabeled(_id);
+        } else {
+            _id.resize(n);
+            for (std::int32_t v = 0; v < n; ++v) _id[v] = v;
+            _g = g;
+        }
+        _index.resize(n);
+        for (std::int32_t k = 0; k < n; ++k) _index[_id[k]] = k;
+        _state.assign(n, static_cast<std::uint8_t>(CellState::Susceptible));
+        _next.resize(n);
+        _counts.susceptible = n;
+    }
+
+    // Accessors
+    std::int32_t size() const { return _g.vertexCount(); }
+    int day() const { return _t; }
+    std::uint64_t seed() const { return _seed; }
+    const SirvRates& rates() const { return _rates; }
+    const ContactGraph& graph() const { return _g; }
+    CellState getState(std::int32_t v) const { return static_cast<CellState>(_state[_index[v]]); }
+    Counts countStates() const { return _counts; }
+
+    // Mutators
+    void setState(std::int32_t v, CellState s) {
+        std::uint8_t& code = _state[_index[v]];
+        --countOf(code);
+        code = static_cast<std::uint8_t>(s);
+        ++countOf(code);
+    }
+
+    /**
+     * @brief Advances one day.
+     *
+     * Only susceptible vertices scan their neighbor lists; the vaccination cap is evaluated
+     * from the counts at the start of the day, as in Population::Update().
+     */
+    void step() {
+        EPIDEMIC_PHASE("NetworkPopulation::step");
+        constexpr std::uint8_t S = static_cast<std::uint8_t>(CellState::Susceptible);
+        constexpr std::uint8_t I = static_cast<std::uint8_t>(CellState::Infected);
+        const std::int64_t n = size();
+        const int day = _t + 1;
+        const bool allow = vaccinationAllowed(_counts.vaccinated, n, _rates);
+        const bool susVaccine = day >= _rates.tv && allow;
+        const bool recVaccine = day > _rates.tv && allow;
+        const std::uint64_t key = dayKey(_seed, static_cast<std::uint64_t>(day));
+        const std::int64_t* offsets = _g.offsets().data();
+        const std::int32_t* adj = _g.adjacency().data();
+        const std::int32_t* id = _id.data();
+        const std::uint8_t* state = _state.data();
+        std::uint8_t* next = _next.data();
+        const SirvRates r = _rates;
+        std::int64_t cs = 0, ci = 0, cr = 0, cv = 0;
+
+        withVaccineFlags(susVaccine, recVaccine, [&](auto sus, auto rec) {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 4096) reduction(+ : cs, ci, cr, cv)
+#endif
+            for (std::int64_t v = 0; v < n; ++v) {
+                const std::uint8_t self = state[v];
+                int infected = 0;
+                if (self == S) {
+                    for (std::int64_t k = offsets[v]; k < offsets[v + 1]; ++k) infected += state[adj[k]] == I;
+                }
+                const std::uint8_t code = sirvStepCount<decltype(sus)::value, decltype(rec)::value>(
+                    self, infected, counterUniform(key, static_cast<std::uint64_t>(id[v])), r);
+                next[v] = code;
+                cs += code == 0;
+                ci += code == 1;
+                cr += code == 2;
+                cv += code == 3;
+            }
+        });
+
+        _state.swap(_next);
+        _counts.susceptible = cs;
+        _counts.infected    = ci;
+        _counts.recovered   = cr;
+        _counts.vaccinated  = cv;
+        _t = day;
+    }
+
+    /**
+     * @brief Advances k days.
+     */
+    void advance(int k) {
+        for (int s = 0; s < k; ++s) step();
+    }
+};
+
+#endif // CONTACT_NETWORK_HPP
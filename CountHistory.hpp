@@ -0,0 +1,104 @@
+/**
+ * @file CountHistory.hpp
+ * @brief Fixed-capacity ring buffer of per-step state counts, with min/max decimation for plotting.
+ */
+
+#ifndef COUNT_HISTORY_HPP
+#define COUNT_HISTORY_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "Population.hpp"
+
+/**
+ * @class CountHistory
+ * @brief The counts of the last capacity() steps, oldest first.
+ *
+ * Memory is fixed at construction: once full, each push overwrites the oldest step, so a
+ * live plot of a run of any length costs the same.
+ */
+class CountHistory {
+public:
+    using Sample = std::array<std::int64_t, 4>; /** <Counts indexed by CellState */
+
+    /**
+     * @brief Range of each state's count over the steps that fall in one plot column.
+     */
+    struct Column {
+        Sample min, max;    /** <Extremes over the column */
+        Sample first, last; /** <Oldest and newest sample of the column, to join neighboring columns */
+    };
+
+private:
+    std::vector<Sample> _ring;
+    std::size_t _head = 0;  /** <Index of the oldest sample once the ring is full */
+    std::size_t _size = 0;
+    std::int64_t _pushed = 0; /** <Samples pushed since construction */
+
+public:
+    /**
+     * @param capacity Number of most recent steps kept; at least 1.
+     */
+    explicit CountHistory(std::size_t capacity) : _ring(capacity) {
+        if (capacity == 0) throw std::invalid_argument("CountHistory: capacity must be positive");
+    }
+
+    void push(const Population::Counts& c) {
+        const Sample s = {c.susceptible, c.infected, c.recovered, c.vaccinated};
+        if (_size < _ring.size()) {
+            _ring[_size++] = s;
+        } else {
+            _ring[_head] = s;
+            _head = (_head + 1) % _ring.size();
+        }
+        ++_pushed;
+    }
+
+    void clear() { _head = _size = 0; _pushed = 0; }
+
+    std::size_t size() const { return _size; }
+    std::size_t capacity() const { return _ring.size(); }
+
+    /**
+     * @brief Index, counted from the first push, of the oldest sample still held.
+     */
+    std::int64_t firstIndex() const { return _pushed - static_cast<std::int64_t>(_size); }
+
+    /**
+     * @brief The k-th oldest sample held (0 <= k < size()).
+     */
+    const Sample& operator[](std::size_t k) const {
+        const std::size_t i = _head + k;
+        return _ring[i < _ring.size() ? i : i - _ring.size()];
+    }
+
+    /**
+     * @brief Splits the held samples into at most maxColumns consecutive groups of (nearly) equal length
+     *        and summarizes each; with fewer samples than columns each sample is its own column.
+     * @param maxColumns Width of the plot in columns (e.g. pixels).
+     * @param out Replaced by the columns, oldest first.
+     */
+    void decimate(std::size_t maxColumns, std::vector<Column>& out) const {
+        const std::size_t columns = std::min(_size, maxColumns);
+        out.resize(columns);
+        for (std::size_t c = 0; c < columns; ++c) {
+            const std::size_t begin = c * _size / columns;
+            const std::size_t end = (c + 1) * _size / columns;
+            Column& col = out[c];
+            col.first = col.min = col.max = (*this)[begin];
+            for (std::size_t k = begin + 1; k < end; ++k) {
+                const Sample& s = (*this)[k];
+                for (int st = 0; st < 4; ++st) {
+                    col.min[st] = std::min(col.min[st], s[st]);
+                    col.max[st] = std::max(col.max[st], s[st]);
+                }
+            }
+            col.last = (*this)[end - 1];
+        }
+    }
+};
+
+#endif // COUNT_HISTORY_HPP
@@ -0,0 +1,282 @@
+/**
+ * @file EventLog.hpp
+ * @brief Compact on-disk log of every state transition of a run, for replay without re-simulating.
+ */
+
+#ifndef EVENT_LOG_HPP
+#define EVENT_LOG_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "CellState.hpp"
+
+/**
+ * File layout (all integers are unsigned LEB128 varints):
+ *
+ *   "SIRVLOG1"                               8-byte magic
+ *   n                                        grid side length
+ *   (run - 1) << 2 | code, ...               initial grid, run-length encoded, n*n cells
+ *   then for each day with transitions, and for the last day of the run:
+ *     day - previous day                     positive; the first record counts from day 0
+ *     k                                      number of transitions (0 only in the last record)
+ *     (cell - previous cell) << 4 | from << 2 | to, k times
+ *
+ * Within a day transitions are sorted by cell (stably, so a cell that changes twice keeps its
+ * order), which makes the cell deltas small and non-negative: a busy day costs one or two
+ * bytes per transition. Days without transitions are not written, except the last day of the
+ * run, which ends the log even when nothing changed on it, so that the log records how many
+ * days the run lasted.
+ */
+namespace eventlog {
+
+constexpr char kMagic[8] = {'S', 'I', 'R', 'V', 'L', 'O', 'G', '1'};
+
+inline void putVarint(std::vector<std::uint8_t>& out, std::uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(v));
+}
+
+} // namespace eventlog
+
+/**
+ * @class EventLogWriter
+ * @brief Appends each day's transitions to an event log; encoding and writing happen on a background thread.
+ *
+ * append() only moves the day's transitions into a queue, so the simulation thread pays a
+ * copy of the changes and nothing else. If the writer falls more than maxQueued days behind,
+ * append() waits for it, which bounds the memory held by the queue.
+ */
+class EventLogWriter {
+    std::ofstream _out;
+    std::size_t _maxQueued;
+    std::deque<std::pair<int, std::vector<CellTransition>>> _queue;
+    std::mutex _mutex;
+    std::condition_variable _ready;   /** <Signals the writer: work queued or closing */
+    std::condition_variable _drained; /** <Signals append(): the queue shrank */
+    bool _closing = false;
+    bool _failed = false;
+    int _lastDay = 0;   /** <Last day passed to append() */
+    int _queuedDay = 0; /** <Last day queued for writing */
+    std::thread _thread;
+
+    void run() {
+        std::vector<std::uint8_t> buffer;
+        int previousDay = 0;
+        for (;;) {
+            std::pair<int, std::vector<CellTransition>> item;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _ready.wait(lock, [&] { return _closing || !_queue.empty(); });
+                if (_queue.empty()) return;
+                item = std::move(_queue.front());
+                _queue.pop_front();
+            }
+            _drained.notify_one();
+
+            std::vector<CellTransition>& t = item.second;
+            std::stable_sort(t.begin(), t.end(),
+                             [](const CellTransition& a, const CellTransition& b) { return a.cell < b.cell; });
+            buffer.clear();
+            eventlog::putVarint(buffer, static_cast<std::uint64_t>(item.first - previousDay));
+            eventlog::putVarint(buffer, t.size());
+            std::int32_t previousCell = 0;
+            for (const CellTransition& c : t) {
+                const std::uint64_t codes = static_cast<std::uint64_t>(c.from) << 2 | static_cast<std::uint64_t>(c.to);
+                eventlog::putVarint(buffer, static_cast<std::uint64_t>(c.cell - previousCell) << 4 | codes);
+                previousCell = c.cell;
+            }
+            previousDay = item.first;
+            _out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+            if (!_out) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _failed = true;
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief Creates the log and writes its header and the initial grid.
+     * @param path File to create (truncated if it exists).
+     * @param n Grid side length.
+     * @param initialCodes n×n CellState bytes at day 0, row-major (e.g. Population::stateCodes()).
+     * @param maxQueued Days that may wait for the writer before append() blocks.
+     */
+    EventLogWriter(const std::string& path, int n, const std::vector<std::uint8_t>& initialCodes,
+                   std::size_t maxQueued = 64)
+    : _out(path, std::ios::binary | std::ios::trunc), _maxQueued(std::max<std::size_t>(maxQueued, 1)) {
+        if (n <= 0 || initialCodes.size() != static_cast<std::size_t>(n) * n) {
+            throw std::invalid_argument("EventLogWriter: expected n*n initial state codes");
+        }
+        if (!_out) throw std::runtime_error("EventLogWriter: cannot create '" + path + "'");
+
+        std::vector<std::uint8_t> header(eventlog::kMagic, eventlog::kMagic + sizeof(eventlog::kMagic));
+        eventlog::putVarint(header, static_cast<std::uint64_t>(n));
+        for (std::size_t k = 0; k < initialCodes.size();) {
+            std::size_t run = 1;
+            while (k + run < initialCodes.size() && initialCodes[k + run] == initialCodes[k]) ++run;
+            eventlog::putVarint(header, static_cast<std::uint64_t>(run - 1) << 2 | initialCodes[k]);
+            k += run;
+        }
+        _out.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+        if (!_out) throw std::runtime_error("EventLogWriter: cannot write '" + path + "'");
+        _thread = std::thread(&EventLogWriter::run, this);
+    }
+
+    EventLogWriter(const EventLogWriter&) = delete;
+    EventLogWriter& operator=(const EventLogWriter&) = delete;
+
+    ~EventLogWriter() { close(); }
+
+    /**
+     * @brief Queues the transitions of one day.
+     * @param day Day the transitions led to; must increase from call to call.
+     * @param transitions The day's state changes, in the order they were made.
+     */
+    void append(int day, std::vector<CellTransition> transitions) {
+        if (day <= _lastDay) throw std::invalid_argument("EventLogWriter::append: days must increase");
+        _lastDay = day;
+        if (transitions.empty()) return;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _drained.wait(lock, [&] { return _queue.size() < _maxQueued; });
+            _queue.emplace_back(day, std::move(transitions));
+        }
+        _queuedDay = day;
+        _ready.notify_one();
+    }
+
+    /**
+     * @brief Writes everything queued, ending with an empty record for the last appended day if
+     *        it had no transitions, and closes the file; later calls do nothing.
+     * @return false if any write failed.
+     */
+    bool close() {
+        if (_thread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (_lastDay > _queuedDay) _queue.emplace_back(_lastDay, std::vector<CellTransition>());
+                _closing = true;
+            }
+            _ready.notify_one();
+            _thread.join();
+            _out.close();
+            if (_out.fail()) _failed = true;
+        }
+        return !_failed;
+    }
+};
+
+/**
+ * @class EventLogReader
+ * @brief Reads an event log back: the initial grid, then the transitions day by day.
+ *
+ * Applying each day's transitions in order to initialCodes() reproduces the grid of every day
+ * of the logged run exactly.
+ */
+class EventLogReader {
+    std::ifstream _in;
+    std::vector<char> _buffer;
+    std::size_t _pos = 0, _end = 0;
+    int _n = 0;
+    int _day = 0;
+    std::vector<std::uint8_t> _initial;
+
+    bool fill() {
+        _in.read(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+        _end = static_cast<std::size_t>(_in.gcount());
+        _pos = 0;
+        return _end > 0;
+    }
+
+    bool atEnd() { return _pos == _end && !fill(); }
+
+    std::uint64_t varint() {
+        std::uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (atEnd()) throw std::runtime_error("EventLogReader: truncated log");
+            const std::uint8_t byte = static_cast<std::uint8_t>(_buffer[_pos++]);
+            v |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return v;
+        }
+        throw std::runtime_error("EventLogReader: malformed varint");
+    }
+
+public:
+    /**
+     * @brief Opens a log and reads its header and initial grid.
+     */
+    explicit EventLogReader(const std::string& path) : _in(path, std::ios::binary), _buffer(1 << 16) {
+        if (!_in) throw std::runtime_error("EventLogReader: cannot open '" + path + "'");
+        char magic[sizeof(eventlog::kMagic)];
+        for (char& c : magic) {
+            if (atEnd()) throw std::runtime_error("EventLogReader: '" + path + "' is not an event log");
+            c = _buffer[_pos++];
+        }
+        if (std::memcmp(magic, eventlog::kMagic, sizeof(magic)) != 0) {
+            throw std::runtime_error("EventLogReader: '" + path + "' is not an event log");
+        }
+        const std::uint64_t n = varint();
+        if (n == 0 || n > 46340) throw std::runtime_error("EventLogReader: bad grid size");
+        _n = static_cast<int>(n);
+        const std::size_t cells = static_cast<std::size_t>(n) * n;
+        _initial.reserve(cells);
+        while (_initial.size() < cells) {
+            const std::uint64_t v = varint();
+            const std::uint64_t run = (v >> 2) + 1;
+            if (run > cells - _initial.size()) throw std::runtime_error("EventLogReader: bad initial grid");
+            _initial.insert(_initial.end(), static_cast<std::size_t>(run), static_cast<std::uint8_t>(v & 3));
+        }
+    }
+
+    int size() const { return _n; }
+
+    /**
+     * @brief Grid at day 0, one CellState byte per cell, row-major.
+     */
+    const std::vector<std::uint8_t>& initialCodes() const { return _initial; }
+
+    /**
+     * @brief Reads the next day that has transitions, or the last day of the run (which may have none).
+     * @param day Set to that day.
+     * @param transitions Replaced by its transitions, sorted by cell.
+     * @return false at the end of the log.
+     */
+    bool next(int& day, std::vector<CellTransition>& transitions) {
+        if (atEnd()) return false;
+        const std::uint64_t delta = varint();
+        if (delta == 0 || delta > static_cast<std::uint64_t>(std::numeric_limits<int>::max() - _day)) {
+            throw std::runtime_error("EventLogReader: days must increase");
+        }
+        _day += static_cast<int>(delta);
+        const std::uint64_t k = varint();
+        const std::int64_t cells = static_cast<std::int64_t>(_n) * _n;
+        transitions.clear();
+        std::int64_t cell = 0;
+        for (std::uint64_t e = 0; e < k; ++e) {
+            const std::uint64_t v = varint();
+            cell += static_cast<std::int64_t>(v >> 4);
+            if (cell >= cells) throw std::runtime_error("EventLogReader: cell index out of range");
+            transitions.push_back({static_cast<std::int32_t>(cell), static_cast<CellState>((v >> 2) & 3),
+                                   static_cast<CellState>(v & 3)});
+        }
+        day = _day;
+        return true;
+    }
+};
+
+#endif // EVENT_LOG_HPP
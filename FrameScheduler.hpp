@@ -0,0 +1,101 @@
+/**
+ * @file FrameScheduler.hpp
+ * @brief Decides when the interactive loop steps the simulation, renders, or sleeps.
+ */
+
+#ifndef FRAME_SCHEDULER_HPP
+#define FRAME_SCHEDULER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <stdexcept>
+
+/**
+ * @class FrameScheduler
+ * @brief Render-on-demand pacing of simulation steps and frames.
+ *
+ * A frame is rendered only when something visible changed (a step, a camera move, a window
+ * event that needs a repaint; see requestRedraw()) and at most maxFps times per second. In
+ * paced mode a step is due every stepSeconds; in fast mode steps run back to back and frames
+ * are interleaved whenever one is due, so the steps between two frames are simply not drawn
+ * (frame skipping adapts to how long steps and frames take). Between deadlines idleSeconds()
+ * says how long the loop may block waiting for input instead of spinning.
+ */
+class FrameScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    Clock::duration _stepInterval;
+    Clock::duration _frameInterval;
+    Clock::time_point _nextStep;
+    Clock::time_point _nextFrame;
+    bool _fast = false;
+    bool _dirty = true; /** <Something visible changed since the last frame */
+
+public:
+    /**
+     * @param stepSeconds Time between steps in paced mode.
+     * @param maxFps Upper bound on frames per second in both modes.
+     */
+    FrameScheduler(double stepSeconds, double maxFps)
+    : _stepInterval(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(stepSeconds))),
+      _frameInterval(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / maxFps))),
+      _nextStep(Clock::now() + _stepInterval), _nextFrame(Clock::now()) {
+        if (!(stepSeconds >= 0.0) || !(maxFps > 0.0)) {
+            throw std::invalid_argument("FrameScheduler: stepSeconds must be >= 0 and maxFps > 0");
+        }
+    }
+
+    /**
+     * @brief Switches between paced steps and simulating as fast as possible.
+     */
+    void setFastMode(bool on) {
+        _fast = on;
+        _nextStep = Clock::now() + (on ? Clock::duration::zero() : _stepInterval);
+        _dirty = true;
+    }
+
+    bool fastMode() const { return _fast; }
+
+    /**
+     * @brief Whether the next step should run now; in fast mode, unless a frame is due first.
+     */
+    bool stepDue(Clock::time_point now) const { return _fast ? !frameDue(now) : now >= _nextStep; }
+
+    /**
+     * @brief Records that a step ran, which also makes the display stale.
+     */
+    void stepped(Clock::time_point now) {
+        _nextStep = now + _stepInterval;
+        _dirty = true;
+    }
+
+    /**
+     * @brief Marks the display stale without a step (camera moved, window needs repainting).
+     */
+    void requestRedraw() { _dirty = true; }
+
+    bool frameDue(Clock::time_point now) const { return _dirty && now >= _nextFrame; }
+
+    void rendered(Clock::time_point now) {
+        _dirty = false;
+        _nextFrame = now + _frameInterval;
+    }
+
+    /**
+     * @brief How long the loop may wait for input before a step or frame is due.
+     * @param moreSteps Whether the simulation still has steps to run.
+     * @return Seconds to wait (0: poll and carry on), or nothing if only input can create work.
+     */
+    std::optional<double> idleSeconds(Clock::time_point now, bool moreSteps) const {
+        std::optional<Clock::time_point> wake;
+        if (moreSteps) wake = _fast ? now : _nextStep;
+        if (_dirty) wake = wake ? std::min(*wake, _nextFrame) : _nextFrame;
+        if (!wake) return std::nullopt;
+        return std::max(0.0, std::chrono::duration<double>(*wake - now).count());
+    }
+};
+
+#endif // FRAME_SCHEDULER_HPP
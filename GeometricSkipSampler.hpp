@@ -0,0 +1,73 @@
+/**
+ * @file GeometricSkipSampler.hpp
+ * @brief Geometric skip-sampling of rare Bernoulli events over a list of candidates.
+ */
+
+#ifndef GEOMETRIC_SKIP_SAMPLER_HPP
+#define GEOMETRIC_SKIP_SAMPLER_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+
+/**
+ * @class GeometricSkipSampler
+ * @brief Visits the candidates of an independent Bernoulli(p) trial sequence that succeed,
+ *        without drawing a uniform for every candidate.
+ *
+ * The number of failures before the next success is Geometric(p), so it is drawn directly as
+ * floor(log(U) / log(1 - p)). The cost is one random number per success (plus one to step past
+ * the end of the list) instead of one per candidate, and each candidate still fires
+ * independently with probability exactly p.
+ */
+class GeometricSkipSampler {
+private:
+    double _p;    /** <Per-candidate success probability */
+    double _logq; /** <log(1 - p), cached so each gap costs a single log */
+
+public:
+    /**
+     * @brief Constructs a sampler for per-candidate probability p.
+     * @param p Success probability; values <= 0 never fire and values >= 1 always fire.
+     */
+    explicit GeometricSkipSampler(double p)
+    : _p(p), _logq(p > 0.0 && p < 1.0 ? std::log1p(-p) : 0.0) {}
+
+    double probability() const { return _p; }
+
+    /**
+     * @brief Draws the number of failures before the next success.
+     * @param gen Uniform random bit generator.
+     * @return The gap as a double, since it can exceed any list length when p is tiny.
+     */
+    template <class Gen>
+    double nextGap(Gen& gen) const {
+        std::uniform_real_distribution<double> dis(0.0, 1.0);
+        return std::floor(std::log(1.0 - dis(gen)) / _logq); // 1 - U lies in (0, 1]
+    }
+
+    /**
+     * @brief Calls visit(k) for every candidate index k in [0, count) that fires.
+     * @param count Number of candidates.
+     * @param gen Uniform random bit generator.
+     * @param visit Callback invoked with the index of each firing candidate, in increasing order.
+     */
+    template <class Gen, class Visit>
+    void forEachHit(std::size_t count, Gen& gen, Visit&& visit) const {
+        if (count == 0 || _p <= 0.0) return;
+        if (_p >= 1.0) {
+            for (std::size_t k = 0; k < count; ++k) visit(k);
+            return;
+        }
+        std::size_t k = 0;
+        while (true) {
+            double gap = nextGap(gen);
+            if (gap >= static_cast<double>(count - k)) return;
+            k += static_cast<std::size_t>(gap);
+            visit(k);
+            if (++k >= count) return;
+        }
+    }
+};
+
+#endif // GEOMETRIC_SKIP_SAMPLER_HPP
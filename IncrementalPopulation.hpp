@@ -0,0 +1,257 @@
+/**
+ * @file IncrementalPopulation.hpp
+ * @brief Discrete-day SIRV engine with incrementally maintained infected-neighbor counts.
+ */
+
+#ifndef INCREMENTAL_POPULATION_HPP
+#define INCREMENTAL_POPULATION_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "Boundary.hpp"
+#include "CellState.hpp"
+#include "GeometricSkipSampler.hpp"
+#include "PhaseTimer.hpp"
+#include "SirvRules.hpp"
+
+/**
+ * @class IncrementalPopulation
+ * @brief The same day-by-day Markov chain as Population::Update(), with cost proportional to
+ *        the number of transitions instead of the grid area.
+ *
+ * Every cell keeps a counter of its infected von Neumann neighbors, changed only when a
+ * neighbor enters or leaves the infected state. The counter and the state select one of
+ * seven buckets (susceptible with 0..4 infected neighbors, infected, recovered; vaccinated
+ * cells have no transitions and are in none), and all cells of a bucket share the same daily
+ * event probability, which is a table lookup. A day is then: for each bucket, skip-sample
+ * its firing cells with GeometricSkipSampler against the start-of-day state, then apply the
+ * collected transitions, moving cells between buckets by swap-remove. Buckets are unordered
+ * arrays with a per-cell slot index, so a move is O(1).
+ *
+ * The per-cell probabilities and the synchronous update are those of Update(), so the two
+ * engines sample the same process, but from different random streams.
+ */
+class IncrementalPopulation {
+public:
+    /**
+     * @brief Aggregate counts of each state.
+     */
+    struct Counts {
+    std::int64_t susceptible = 0;
+    std::int64_t infected = 0;
+    std::int64_t recovered = 0;
+    std::int64_t vaccinated = 0;
+    };
+
+private:
+    static constexpr int kInfected = 5;  /** <Bucket of infected cells; 0..4 are susceptible by count */
+    static constexpr int kRecovered = 6; /** <Bucket of recovered cells */
+    static constexpr int kBuckets = 7;
+    static constexpr int kNone = 7;      /** <Vaccinated cells are in no bucket */
+
+    int _n;
+    SirvRates _rates;
+    Boundary _boundary;
+    std::mt19937_64 _gen;
+    int _t = 0;
+    std::vector<std::uint8_t> _state;    /** <CellState code per cell */
+    std::vector<std::uint8_t> _count;    /** <Infected neighbors per cell (a neighbor reached twice counts twice) */
+    std::vector<std::int32_t> _slot;     /** <Position of each cell in its bucket */
+    std::vector<std::int32_t> _buckets[kBuckets];
+    std::int64_t _vaccinated = 0;
+    std::vector<std::pair<std::int32_t, std::uint8_t>> _changes; /** <Transitions of the current day */
+
+    int bucketOf(std::int32_t c) const {
+        switch (static_cast<CellState>(_state[c])) {
+            case CellState::Susceptible: return _count[c];
+            case CellState::Infected:    return kInfected;
+            case CellState::Recovered:   return kRecovered;
+            default:                     return kNone;
+        }
+    }
+
+    void enter(std::int32_t c, int b) {
+        if (b == kNone) {
+            ++_vaccinated;
+            return;
+        }
+        _slot[c] = static_cast<std::int32_t>(_buckets[b].size());
+        _buckets[b].push_back(c);
+    }
+
+    void leave(std::int32_t c, int b) {
+        if (b == kNone) {
+            --_vaccinated;
+            return;
+        }
+        std::vector<std::int32_t>& bucket = _buckets[b];
+        const std::int32_t last = bucket.back();
+        bucket[_slot[c]] = last;
+        _slot[last] = _slot[c];
+        bucket.pop_back();
+    }
+
+    /**
+     * @brief Calls f(neighbor) for each von Neumann neighbor of c that exists under the boundary.
+     */
+    template <class F>
+    void forEachNeighbor(std::int32_t c, F&& f) const {
+        const int i = c / _n, j = c % _n;
+        const int di[4] = {-1, 1, 0, 0}, dj[4] = {0, 0, -1, 1};
+        for (int d = 0; d < 4; ++d) {
+            int a = i + di[d], b = j + dj[d];
+            if (a < 0 || a >= _n || b < 0 || b >= _n) {
+                if (_boundary == Boundary::Closed) continue;
+                a = boundaryIndex(a, _n, _boundary);
+                b = boundaryIndex(b, _n, _boundary);
+            }
+            f(a * _n + b);
+        }
+    }
+
+    /**
+     * @brief Adds delta to the infected-neighbor counter of every cell that has c as a neighbor,
+     *        once per time it reaches c.
+     *
+     * The neighbor relation is symmetric but not always with the same multiplicity: under a
+     * reflecting boundary an edge cell reaches its inside neighbor twice, while that neighbor
+     * reaches it once. So each distinct neighbor m of c is shifted by delta times the number
+     * of m's neighbors that are c.
+     */
+    void shiftNeighborCounts(std::int32_t c, int delta) {
+        std::int32_t seen[4];
+        int distinct = 0;
+        forEachNeighbor(c, [&](std::int32_t m) {
+            if (std::find(seen, seen + distinct, m) != seen + distinct) return;
+            seen[distinct++] = m;
+            int times = 0;
+            forEachNeighbor(m, [&](std::int32_t x) { times += x == c; });
+            const bool susceptible = _state[m] == static_cast<std::uint8_t>(CellState::Susceptible);
+            if (susceptible) leave(m, _count[m]);
+            _count[m] = static_cast<std::uint8_t>(_count[m] + delta * times);
+            if (susceptible) enter(m, _count[m]);
+        });
+    }
+
+    /**
+     * @brief Changes the state of c, keeping the buckets and the neighbor counters consistent.
+     */
+    void move(std::int32_t c, std::uint8_t code) {
+        constexpr std::uint8_t I = static_cast<std::uint8_t>(CellState::Infected);
+        const std::uint8_t old = _state[c];
+        if (old == code) return;
+        leave(c, bucketOf(c));
+        _state[c] = code;
+        enter(c, bucketOf(c));
+        if (old == I) shiftNeighborCounts(c, -1);
+        if (code == I) shiftNeighborCounts(c, +1);
+    }
+
+public:
+    /**
+     * @brief Creates an all-susceptible n×n grid.
+     * @param n Grid side length.
+     * @param seed Seed of the generator.
+     * @param rates Model rates.
+     * @param boundary Boundary condition of the von Neumann neighborhood.
+     */
+    IncrementalPopulation(int n, std::uint64_t seed, const SirvRates& rates = SirvRates{},
+                          Boundary boundary = Boundary::Closed)
+    : _n(n), _rates(rates), _boundary(boundary), _gen(seed) {
+        if (n <= 0 || n > 46340) throw std::invalid_argument("IncrementalPopulation: n must be in [1, 46340]");
+        const std::int32_t cells = n * n;
+        _state.assign(cells, static_cast<std::uint8_t>(CellState::Susceptible));
+        _count.assign(cells, 0);
+        _slot.resize(cells);
+        _buckets[0].resize(cells);
+        for (std::int32_t c = 0; c < cells; ++c) {
+            _buckets[0][c] = c;
+            _slot[c] = c;
+        }
+    }
+
+    // Accessors
+    int size() const { return _n; }
+    int day() const { return _t; }
+    CellState getState(int i, int j) const { return static_cast<CellState>(_state[i * _n + j]); }
+    int infectedNeighbors(int i, int j) const { return _count[i * _n + j]; }
+
+    Counts countStates() const {
+        Counts c;
+        for (int k = 0; k < kInfected; ++k) c.susceptible += static_cast<std::int64_t>(_buckets[k].size());
+        c.infected   = static_cast<std::int64_t>(_buckets[kInfected].size());
+        c.recovered  = static_cast<std::int64_t>(_buckets[kRecovered].size());
+        c.vaccinated = _vaccinated;
+        return c;
+    }
+
+    // Mutators
+    void setState(int i, int j, CellState s) { move(i * _n + j, static_cast<std::uint8_t>(s)); }
+
+    /**
+     * @brief Advances one day.
+     */
+    void step() {
+        EPIDEMIC_PHASE("IncrementalPopulation::step");
+        constexpr std::uint8_t S = static_cast<std::uint8_t>(CellState::Susceptible);
+        constexpr std::uint8_t I = static_cast<std::uint8_t>(CellState::Infected);
+        constexpr std::uint8_t R = static_cast<std::uint8_t>(CellState::Recovered);
+        constexpr std::uint8_t V = static_cast<std::uint8_t>(CellState::Vaccinated);
+        ++_t;
+        const bool allow = vaccinationAllowed(_vaccinated, static_cast<std::int64_t>(_n) * _n, _rates);
+        const bool susVaccine = _t >= _rates.tv && allow;
+        const bool recVaccine = _t > _rates.tv && allow;
+        std::uniform_real_distribution<double> dis(0.0, 1.0);
+
+        //daily probability of each bucket's first outcome (infection, recovery, mutation) and of
+        //any event; as in Update(), a uniform below first gives the first outcome and one in
+        //[first, event) the second (vaccination)
+        double first[kBuckets], event[kBuckets];
+        std::uint8_t firstState[kBuckets], secondState[kBuckets];
+        for (int k = 0; k < kInfected; ++k) {
+            first[k] = k * static_cast<double>(_rates.ri);
+            event[k] = first[k] + (susVaccine ? _rates.rv : 0.0f);
+            firstState[k] = I;
+            secondState[k] = V;
+        }
+        first[kInfected] = event[kInfected] = _rates.rr;
+        firstState[kInfected] = secondState[kInfected] = R;
+        first[kRecovered] = _rates.rm;
+        event[kRecovered] = first[kRecovered] + (recVaccine ? _rates.rv : 0.0f);
+        firstState[kRecovered] = S;
+        secondState[kRecovered] = V;
+
+        //decide every transition from the start-of-day state...
+        _changes.clear();
+        for (int b = 0; b < kBuckets; ++b) {
+            const std::vector<std::int32_t>& bucket = _buckets[b];
+            const double p = std::min(event[b], 1.0);
+            const bool both = first[b] > 0.0 && event[b] > first[b];
+            GeometricSkipSampler(p).forEachHit(bucket.size(), _gen, [&](std::size_t k) {
+                //a firing cell's uniform is uniform on [0, p), so one more draw splits the outcomes
+                const bool isFirst = first[b] > 0.0 && (!both || dis(_gen) * p < first[b]);
+                _changes.emplace_back(bucket[k], isFirst ? firstState[b] : secondState[b]);
+            });
+        }
+        //...then apply them
+        for (const auto& change : _changes) move(change.first, change.second);
+    }
+
+    /**
+     * @brief Advances k days.
+     */
+    void advance(int k) {
+        for (int s = 0; s < k; ++s) step();
+    }
+
+    /**
+     * @brief Transitions applied by the last step, as (cell index, new CellState code).
+     */
+    const std::vector<std::pair<std::int32_t, std::uint8_t>>& lastChanges() const { return _changes; }
+};
+
+#endif // INCREMENTAL_POPULATION_HPP
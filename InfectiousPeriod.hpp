@@ -0,0 +1,112 @@
+/**
+ * @file InfectiousPeriod.hpp
+ * @brief Distribution of the number of days a person stays infected, as a per-day hazard table.
+ */
+
+#ifndef INFECTIOUS_PERIOD_HPP
+#define INFECTIOUS_PERIOD_HPP
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+/**
+ * @class InfectiousPeriod
+ * @brief Recovery probability as a function of how many days a person has already been infected.
+ *
+ * hazard(a) is the chance of recovering today for someone infected for a full days, i.e.
+ * P(D = a + 1 | D > a) for the infectious period D (the number of daily snapshots in which
+ * the person is infected). Ages saturate at 255, so beyond that the last hazard applies
+ * every day (a geometric tail).
+ */
+class InfectiousPeriod {
+public:
+    static constexpr int kMaxAge = 255;
+
+private:
+    std::array<float, kMaxAge + 1> _hazard{}; /** <Recovery probability by days infected */
+
+    /**
+     * @brief Regularized lower incomplete gamma function P(s, x), the gamma CDF with unit scale.
+     */
+    static double gammaP(double s, double x) {
+        if (x <= 0.0) return 0.0;
+        const double logPrefix = s * std::log(x) - x - std::lgamma(s);
+        if (x < s + 1.0) {
+            //series: P = x^s e^-x / Γ(s) · Σ x^n / (s (s+1) ... (s+n))
+            double term = 1.0 / s, sum = term;
+            for (int n = 1; n < 500; ++n) {
+                term *= x / (s + n);
+                sum += term;
+                if (term < sum * 1e-15) break;
+            }
+            return std::exp(logPrefix) * sum;
+        }
+        //continued fraction for Q = 1 - P (modified Lentz)
+        const double tiny = 1e-300;
+        double b = x + 1.0 - s, c = 1.0 / tiny, d = 1.0 / b, h = d;
+        for (int n = 1; n < 500; ++n) {
+            const double an = -n * (n - s);
+            b += 2.0;
+            d = an * d + b;
+            if (std::fabs(d) < tiny) d = tiny;
+            c = b + an / c;
+            if (std::fabs(c) < tiny) c = tiny;
+            d = 1.0 / d;
+            const double delta = d * c;
+            h *= delta;
+            if (std::fabs(delta - 1.0) < 1e-15) break;
+        }
+        return 1.0 - std::exp(logPrefix) * h;
+    }
+
+public:
+    /**
+     * @brief The original model: recovery with probability rr every day, whatever the age.
+     */
+    static InfectiousPeriod geometric(float rr) {
+        if (!(rr >= 0.0f && rr <= 1.0f)) throw std::invalid_argument("InfectiousPeriod::geometric: rr must be in [0, 1]");
+        InfectiousPeriod p;
+        p._hazard.fill(rr);
+        return p;
+    }
+
+    /**
+     * @brief Everyone is infected for exactly the given number of days.
+     * @param days Between 1 and 256.
+     */
+    static InfectiousPeriod fixed(int days) {
+        if (days < 1 || days > kMaxAge + 1) throw std::invalid_argument("InfectiousPeriod::fixed: days must be in [1, 256]");
+        InfectiousPeriod p;
+        for (int a = 0; a <= kMaxAge; ++a) p._hazard[a] = a + 1 >= days ? 1.0f : 0.0f;
+        return p;
+    }
+
+    /**
+     * @brief Gamma-distributed infectious period, rounded up to whole days.
+     * @param shape Gamma shape k; 1 is exponential, larger is more peaked around the mean.
+     * @param meanDays Mean of the continuous distribution, in days.
+     */
+    static InfectiousPeriod gamma(double shape, double meanDays) {
+        if (!(shape > 0.0) || !(meanDays > 0.0)) {
+            throw std::invalid_argument("InfectiousPeriod::gamma: shape and mean must be positive");
+        }
+        const double scale = meanDays / shape;
+        InfectiousPeriod p;
+        double survivor = 1.0; // P(D > a)
+        for (int a = 0; a <= kMaxAge; ++a) {
+            const double next = 1.0 - gammaP(shape, (a + 1) / scale);
+            p._hazard[a] = survivor > 1e-12 ? static_cast<float>(1.0 - next / survivor) : 1.0f;
+            survivor = next;
+        }
+        return p;
+    }
+
+    /**
+     * @brief Recovery probability today after a full days of infection (a saturates at kMaxAge).
+     */
+    float hazard(std::uint8_t a) const { return _hazard[a]; }
+};
+
+#endif // INFECTIOUS_PERIOD_HPP
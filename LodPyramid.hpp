@@ -0,0 +1,134 @@
+/**
+ * @file LodPyramid.hpp
+ * @brief Multi-resolution state counts of a grid, for drawing grids far larger than the screen.
+ */
+
+#ifndef LOD_PYRAMID_HPP
+#define LOD_PYRAMID_HPP
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "CellState.hpp"
+
+/**
+ * @class LodPyramid
+ * @brief Per-state cell counts of 2^l × 2^l blocks of an n×n grid for l = kFirstLevel .. kLastLevel,
+ *        plus a byte copy of the grid itself (level 0).
+ *
+ * A viewer showing b×b cells per screen pixel reads level floor(log2 b) and draws each pixel
+ * as the mix of its block's state fractions, so the cost of a frame depends on the window
+ * size, not on n. The pyramid follows the grid through apply(), which moves one count per
+ * level for each CellTransition, so keeping it current costs time in proportion to the
+ * number of cells that changed rather than to n².
+ *
+ * Levels 1 (2×2) and above kLastLevel are not stored: level 1 would cost as much memory as
+ * level 0, and 128×128 blocks are the largest whose counts fit 16 bits. Zoom levels finer
+ * than 4 cells per pixel sample level 0, coarser than 128 sample level kLastLevel. Blocks on
+ * the right and bottom edges may be partial; their counts sum to the cells they cover.
+ */
+class LodPyramid {
+public:
+    static constexpr int kFirstLevel = 2;
+    static constexpr int kLastLevel = 7;
+
+private:
+    /**
+     * @brief One level: four counts per block, blocks row-major.
+     */
+    struct Level {
+        int blocks = 0; /** <Blocks per side */
+        std::vector<std::uint16_t> counts; /** <Indexed [block * 4 + CellState] */
+    };
+
+    int _n = 0;
+    std::vector<std::uint8_t> _codes; /** <Level 0: one CellState byte per cell */
+    std::vector<Level> _levels;       /** <_levels[k] is level kFirstLevel + k */
+
+public:
+    LodPyramid() = default;
+
+    /**
+     * @brief Builds the pyramid of a grid.
+     * @param n Grid side length.
+     * @param codes n×n CellState bytes, row-major (e.g. Population::stateCodes()).
+     */
+    LodPyramid(int n, const std::vector<std::uint8_t>& codes) { assign(n, codes); }
+
+    /**
+     * @brief Rebuilds every level from a full snapshot of the grid.
+     */
+    void assign(int n, const std::vector<std::uint8_t>& codes) {
+        if (n <= 0 || codes.size() != static_cast<std::size_t>(n) * n) {
+            throw std::invalid_argument("LodPyramid::assign: expected n*n state codes");
+        }
+        _n = n;
+        _codes = codes;
+        _levels.clear();
+        for (int l = kFirstLevel; l <= kLastLevel && (1 << (l - 1)) < n; ++l) {
+            Level level;
+            level.blocks = (n + (1 << l) - 1) >> l;
+            level.counts.assign(static_cast<std::size_t>(level.blocks) * level.blocks * 4, 0);
+            if (_levels.empty()) {
+                for (int i = 0; i < n; ++i) {
+                    const std::uint8_t* row = &_codes[static_cast<std::size_t>(i) * n];
+                    std::uint16_t* out = &level.counts[static_cast<std::size_t>(i >> l) * level.blocks * 4];
+                    for (int j = 0; j < n; ++j) ++out[(j >> l) * 4 + row[j]];
+                }
+            } else {
+                //each block is the sum of the 2×2 blocks of the level below
+                const Level& fine = _levels.back();
+                for (int bi = 0; bi < fine.blocks; ++bi) {
+                    for (int bj = 0; bj < fine.blocks; ++bj) {
+                        const std::uint16_t* src = &fine.counts[(static_cast<std::size_t>(bi) * fine.blocks + bj) * 4];
+                        std::uint16_t* dst = &level.counts[(static_cast<std::size_t>(bi >> 1) * level.blocks + (bj >> 1)) * 4];
+                        for (int s = 0; s < 4; ++s) dst[s] = static_cast<std::uint16_t>(dst[s] + src[s]);
+                    }
+                }
+            }
+            _levels.push_back(std::move(level));
+        }
+    }
+
+    /**
+     * @brief Applies state changes, in order, to every level.
+     */
+    void apply(const std::vector<CellTransition>& transitions) {
+        for (const CellTransition& t : transitions) {
+            const int i = t.cell / _n, j = t.cell % _n;
+            _codes[t.cell] = static_cast<std::uint8_t>(t.to);
+            for (std::size_t k = 0; k < _levels.size(); ++k) {
+                const int l = kFirstLevel + static_cast<int>(k);
+                Level& level = _levels[k];
+                std::uint16_t* c = &level.counts[(static_cast<std::size_t>(i >> l) * level.blocks + (j >> l)) * 4];
+                --c[static_cast<int>(t.from)];
+                ++c[static_cast<int>(t.to)];
+            }
+        }
+    }
+
+    int size() const { return _n; }
+
+    /**
+     * @brief Coarsest stored aggregate level, or 0 if the grid is too small to have any.
+     */
+    int topLevel() const { return _levels.empty() ? 0 : kFirstLevel + static_cast<int>(_levels.size()) - 1; }
+
+    CellState state(int i, int j) const { return static_cast<CellState>(_codes[static_cast<std::size_t>(i) * _n + j]); }
+
+    /**
+     * @brief Blocks per side at a stored level (kFirstLevel .. topLevel()).
+     */
+    int blocks(int level) const { return _levels[level - kFirstLevel].blocks; }
+
+    /**
+     * @brief The four per-state counts of block (bi, bj) at a stored level, indexed by CellState.
+     */
+    const std::uint16_t* counts(int level, int bi, int bj) const {
+        const Level& l = _levels[level - kFirstLevel];
+        return &l.counts[(static_cast<std::size_t>(bi) * l.blocks + bj) * 4];
+    }
+};
+
+#endif // LOD_PYRAMID_HPP
@@ -0,0 +1,308 @@
+/**
+ * @file MappedPopulation.hpp
+ * @brief Out-of-core SIRV engine whose state planes live in a memory-mapped file.
+ */
+
+#ifndef MAPPED_POPULATION_HPP
+#define MAPPED_POPULATION_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "CellState.hpp"
+#include "CounterRng.hpp"
+#include "SirvRules.hpp"
+
+/**
+ * @class MappedPopulation
+ * @brief An n×n SIRV grid stored as two one-byte-per-cell planes in a file mapped with mmap.
+ *
+ * The file is the simulation: a step reads the current plane and writes the other one, then
+ * flips the plane index in the header, so the grid can be far larger than RAM (the kernel pages
+ * rows in and out as the stencil streams through them) and the file is always a consistent
+ * checkpoint of the last completed day. Reopening it maps the planes without any load phase.
+ *
+ * It is a separate engine, not a storage backend of Population. Transitions use the same
+ * rules and counter-based draws as Population::advance(), so it evolves exactly like a
+ * Population with the same seed and initial state under Boundary::Closed (this class has no
+ * other boundary) that is advanced one day per call: advance(k) with k > 1 holds the
+ * vaccination cap fixed for its whole block, while this class re-evaluates it every day.
+ * POSIX only.
+ */
+class MappedPopulation {
+public:
+    /**
+     * @brief Aggregate counts of each state; kept in the header and updated by every step.
+     */
+    struct Counts {
+    std::int64_t susceptible = 0;
+    std::int64_t infected = 0;
+    std::int64_t recovered = 0;
+    std::int64_t vaccinated = 0;
+    };
+
+private:
+    /**
+     * @brief File header, padded to kHeaderBytes.
+     *
+     * The planes start at kHeaderBytes, which is page-aligned wherever the page size divides
+     * 4096 (x86-64 and most Linux systems); elsewhere access hints are simply widened to the
+     * enclosing pages. The value is part of the file format, so it does not follow the page size.
+     */
+    struct Header {
+        char          magic[8];   /** <"SIRVGRID" */
+        std::uint32_t version;    /** <Layout version */
+        std::uint32_t current;    /** <Index (0 or 1) of the plane holding the latest day */
+        std::int64_t  n;          /** <Grid side length */
+        std::int64_t  day;        /** <Days elapsed */
+        std::uint64_t seed;       /** <Seed of the counter-based draws */
+        std::int64_t  counts[4];  /** <Cells per CellState in the current plane */
+        SirvRates     rates;      /** <Model rates */
+    };
+
+    static constexpr std::uint32_t kVersion = 1;
+    static constexpr std::size_t kHeaderBytes = 4096;
+    static_assert(sizeof(Header) <= kHeaderBytes, "MappedPopulation: header does not fit its padding");
+
+    int _fd = -1;                /** <File descriptor of the backing file */
+    std::uint8_t* _base = nullptr; /** <Start of the mapping */
+    std::size_t _bytes = 0;      /** <Length of the mapping */
+    std::size_t _planeBytes = 0; /** <Bytes per plane, rounded up to whole pages */
+    Header* _h = nullptr;        /** <Header at the start of the mapping */
+    std::int64_t _bandRows = 0;  /** <Rows streamed per band in step() */
+
+    static std::size_t pageSize() { return static_cast<std::size_t>(sysconf(_SC_PAGESIZE)); }
+
+    std::uint8_t* plane(std::uint32_t which) const {
+        return _base + kHeaderBytes + static_cast<std::size_t>(which) * _planeBytes;
+    }
+
+    /**
+     * @brief Applies madvise to the pages covering [p, p + len), widened to page boundaries.
+     */
+    void advise(const std::uint8_t* p, std::size_t len, int advice) const {
+        if (len == 0) return;
+        const std::size_t page = pageSize();
+        std::uintptr_t lo = reinterpret_cast<std::uintptr_t>(p) & ~(page - 1);
+        std::uintptr_t hi = reinterpret_cast<std::uintptr_t>(p + len);
+        madvise(reinterpret_cast<void*>(lo), hi - lo, advice);
+    }
+
+    /**
+     * @brief Starts asynchronous write-back of the pages covering [p, p + len).
+     */
+    void writeBack(const std::uint8_t* p, std::size_t len) const {
+        if (len == 0) return;
+        const std::size_t page = pageSize();
+        std::uintptr_t lo = reinterpret_cast<std::uintptr_t>(p) & ~(page - 1);
+        std::uintptr_t hi = reinterpret_cast<std::uintptr_t>(p + len);
+        msync(reinterpret_cast<void*>(lo), hi - lo, MS_ASYNC);
+    }
+
+    void map(std::size_t bytes) {
+        void* base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+        if (base == MAP_FAILED) {
+            close(_fd);
+            throw std::runtime_error("MappedPopulation: mmap failed: " + std::string(std::strerror(errno)));
+        }
+        _base = static_cast<std::uint8_t*>(base);
+        _bytes = bytes;
+        _h = reinterpret_cast<Header*>(_base);
+        madvise(_base, _bytes, MADV_SEQUENTIAL);
+    }
+
+    void chooseBandRows() {
+        //stream in bands of roughly 64 MiB so hints cover many pages at once
+        _bandRows = std::max<std::int64_t>(1, (std::int64_t(64) << 20) / std::max<std::int64_t>(_h->n, 1));
+    }
+
+public:
+    /**
+     * @brief Creates (or truncates) a file holding an all-susceptible n×n grid.
+     *
+     * The planes are allocated with ftruncate, so creation is instant and the file stays
+     * sparse until cells are written (susceptible is code 0).
+     * @param path Backing file.
+     * @param n Grid side length.
+     * @param seed Seed for the per-cell draws.
+     * @param rates Model rates.
+     */
+    MappedPopulation(const std::string& path, std::int64_t n, std::uint64_t seed,
+                     const SirvRates& rates = SirvRates{}) {
+        if (n <= 0) throw std::invalid_argument("MappedPopulation: n must be positive");
+        _fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (_fd < 0) {
+            throw std::runtime_error("MappedPopulation: cannot create '" + path + "': " + std::strerror(errno));
+        }
+        const std::size_t page = pageSize();
+        _planeBytes = (static_cast<std::size_t>(n) * static_cast<std::size_t>(n) + page - 1) / page * page;
+        const std::size_t bytes = kHeaderBytes + 2 * _planeBytes;
+        if (ftruncate(_fd, static_cast<off_t>(bytes)) != 0) {
+            close(_fd);
+            throw std::runtime_error("MappedPopulation: cannot size '" + path + "': " + std::strerror(errno));
+        }
+        map(bytes);
+        std::memcpy(_h->magic, "SIRVGRID", 8);
+        _h->version = kVersion;
+        _h->current = 0;
+        _h->n = n;
+        _h->day = 0;
+        _h->seed = seed;
+        _h->counts[0] = n * n;
+        _h->counts[1] = _h->counts[2] = _h->counts[3] = 0;
+        _h->rates = rates;
+        chooseBandRows();
+    }
+
+    /**
+     * @brief Reopens a grid file written earlier; this is how a checkpoint is resumed.
+     * @param path Backing file.
+     */
+    explicit MappedPopulation(const std::string& path) {
+        _fd = open(path.c_str(), O_RDWR);
+        if (_fd < 0) {
+            throw std::runtime_error("MappedPopulation: cannot open '" + path + "': " + std::strerror(errno));
+        }
+        struct stat st;
+        if (fstat(_fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < kHeaderBytes) {
+            close(_fd);
+            throw std::runtime_error("MappedPopulation: '" + path + "' is not a grid file");
+        }
+        map(static_cast<std::size_t>(st.st_size));
+        if (std::memcmp(_h->magic, "SIRVGRID", 8) != 0 || _h->version != kVersion) {
+            munmap(_base, _bytes);
+            close(_fd);
+            throw std::runtime_error("MappedPopulation: '" + path + "' has an unknown format");
+        }
+        _planeBytes = (_bytes - kHeaderBytes) / 2;
+        //a truncated or corrupt file must not make the planes reach past the mapping
+        const std::int64_t n = _h->n;
+        if (n <= 0 || static_cast<std::size_t>(n) > _planeBytes / static_cast<std::size_t>(n) || _h->current > 1) {
+            munmap(_base, _bytes);
+            close(_fd);
+            throw std::runtime_error("MappedPopulation: '" + path + "' is truncated or corrupt");
+        }
+        chooseBandRows();
+    }
+
+    MappedPopulation(const MappedPopulation&) = delete;
+    MappedPopulation& operator=(const MappedPopulation&) = delete;
+
+    ~MappedPopulation() {
+        if (_base) {
+            msync(_base, _bytes, MS_ASYNC);
+            munmap(_base, _bytes);
+        }
+        if (_fd >= 0) close(_fd);
+    }
+
+    // Accessors
+    std::int64_t size() const { return _h->n; }
+    std::int64_t day() const { return _h->day; }
+    std::uint64_t seed() const { return _h->seed; }
+    const SirvRates& rates() const { return _h->rates; }
+    CellState getState(std::int64_t i, std::int64_t j) const {
+        return static_cast<CellState>(plane(_h->current)[i * _h->n + j]);
+    }
+
+    /**
+     * @brief Counts of each state in the current plane, read from the header (no scan).
+     */
+    Counts countStates() const {
+        Counts c;
+        c.susceptible = _h->counts[0];
+        c.infected    = _h->counts[1];
+        c.recovered   = _h->counts[2];
+        c.vaccinated  = _h->counts[3];
+        return c;
+    }
+
+    // Mutators
+    void setState(std::int64_t i, std::int64_t j, CellState s) {
+        std::uint8_t& cell = plane(_h->current)[i * _h->n + j];
+        --_h->counts[cell];
+        cell = static_cast<std::uint8_t>(s);
+        ++_h->counts[cell];
+    }
+
+    /**
+     * @brief Advances one day, streaming the current plane through the stencil in row bands.
+     *
+     * Each band is prefetched with MADV_WILLNEED; once a band of the new plane is complete it is
+     * scheduled for write-back and, together with the source rows the stencil no longer needs,
+     * released with MADV_DONTNEED so the resident set stays at a few bands regardless of n.
+     * The plane index is flipped only after the whole day is written.
+     */
+    void step() {
+        const std::int64_t n = _h->n;
+        const std::int64_t day = _h->day + 1;
+        const SirvRates& r = _h->rates;
+        const bool allow = vaccinationAllowed(_h->counts[3], n * n, r);
+        const bool susVaccine = day >= r.tv && allow;
+        const bool recVaccine = day > r.tv && allow;
+        const std::uint64_t key = dayKey(_h->seed, static_cast<std::uint64_t>(day));
+        const std::uint8_t* src = plane(_h->current);
+        std::uint8_t* dst = plane(1 - _h->current);
+        const std::uint8_t outside = 0xFF;
+        std::int64_t counts[4] = {0, 0, 0, 0};
+
+        for (std::int64_t b0 = 0; b0 < n; b0 += _bandRows) {
+            const std::int64_t b1 = std::min(b0 + _bandRows, n);
+            const std::int64_t ahead = std::min(b1 + _bandRows, n);
+            advise(src + b1 * n, static_cast<std::size_t>((ahead - b1) * n), MADV_WILLNEED);
+
+            withVaccineFlags(susVaccine, recVaccine, [&](auto sus, auto rec) {
+                for (std::int64_t i = b0; i < b1; ++i) {
+                    const std::uint8_t* row = src + i * n;
+                    const std::uint8_t* up = i > 0 ? row - n : nullptr;
+                    const std::uint8_t* down = i + 1 < n ? row + n : nullptr;
+                    std::uint8_t* out = dst + i * n;
+                    for (std::int64_t j = 0; j < n; ++j) {
+                        std::uint8_t next = sirvStep<decltype(sus)::value, decltype(rec)::value>(
+                            row[j],
+                            up ? up[j] : outside,
+                            down ? down[j] : outside,
+                            j > 0 ? row[j - 1] : outside,
+                            j + 1 < n ? row[j + 1] : outside,
+                            counterUniform(key, static_cast<std::uint64_t>(i * n + j)), r);
+                        out[j] = next;
+                        ++counts[next];
+                    }
+                }
+            });
+
+            writeBack(dst + b0 * n, static_cast<std::size_t>((b1 - b0) * n));
+            //source rows above b1 - 1 are still needed as the "up" row of the next band
+            advise(src + b0 * n, static_cast<std::size_t>((b1 - 1 - b0) * n), MADV_DONTNEED);
+            advise(dst + b0 * n, static_cast<std::size_t>((b1 - b0) * n), MADV_DONTNEED);
+        }
+
+        std::copy(counts, counts + 4, _h->counts);
+        _h->day = day;
+        _h->current = 1 - _h->current;
+    }
+
+    /**
+     * @brief Advances k days.
+     */
+    void advance(int k) {
+        for (int s = 0; s < k; ++s) step();
+    }
+
+    /**
+     * @brief Blocks until the mapping is on disk, making the file a durable checkpoint.
+     * @return true on success.
+     */
+    bool flush() {
+        return msync(_base, _bytes, MS_SYNC) == 0;
+    }
+};
+
+#endif // MAPPED_POPULATION_HPP
@@ -0,0 +1,172 @@
+/**
+ * @file MobilityLayer.hpp
+ * @brief Long-range (travel) contacts from infected cells, sampled in aggregate each day.
+ */
+
+#ifndef MOBILITY_LAYER_HPP
+#define MOBILITY_LAYER_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "AliasTable.hpp"
+#include "Boundary.hpp"
+
+/**
+ * @class MobilityLayer
+ * @brief Remote contacts on top of the local neighborhood: every infected cell makes a
+ *        Poisson(rate) number of contacts per day with cells anywhere on the grid, and each
+ *        contact transmits with probability transmission.
+ *
+ * Nothing is evaluated per pair of cells. Thinning a Poisson process by an independent
+ * Bernoulli(transmission) keeps it Poisson, and the sum over infected cells is Poisson too,
+ * so a day's transmitting contacts are one Poisson(rate * transmission * infected) draw, each
+ * assigned to a uniformly chosen infected source. The target is either uniform over the grid
+ * or at a Chebyshev distance d drawn from an alias table of P(d) ∝ 8d · d^-exponent (the
+ * ring at distance d has 8d cells), then uniform on that ring. The cost per day is
+ * proportional to the number of infected cells plus the number of contacts.
+ */
+class MobilityLayer {
+public:
+    /**
+     * @brief Where a remote contact lands.
+     */
+    enum class Kernel {
+        None,     /** <No remote contacts */
+        Uniform,  /** <Any cell of the grid, uniformly */
+        PowerLaw  /** <Distance from the source drawn with density ∝ d^-exponent */
+    };
+
+private:
+    Kernel _kernel = Kernel::None;
+    double _rate = 0.0;         /** <Mean remote contacts per infected cell per day */
+    double _transmission = 0.0; /** <Probability that a contact with a susceptible cell infects it */
+    double _exponent = 2.0;     /** <Power-law exponent of the distance density */
+    int _maxDistance = 0;       /** <Largest contact distance; 0 means the grid size */
+    AliasTable _distances;      /** <Alias table over d = 1 .. _tableMax */
+    int _tableMax = 0;          /** <Largest distance in _distances */
+
+    void buildDistances(int maxDistance) {
+        std::vector<double> weights(maxDistance);
+        for (int d = 1; d <= maxDistance; ++d) weights[d - 1] = 8.0 * d * std::pow(d, -_exponent);
+        _distances = AliasTable(weights);
+        _tableMax = maxDistance;
+    }
+
+    /**
+     * @brief Offset of the k-th cell (0 <= k < 8d) on the square ring at Chebyshev distance d.
+     */
+    static void ringOffset(int d, int k, int& di, int& dj) {
+        const int side = k / (2 * d), t = k % (2 * d);
+        switch (side) {
+            case 0:  di = -d;    dj = -d + t; break;
+            case 1:  di = -d + t; dj = d;     break;
+            case 2:  di = d;     dj = d - t;  break;
+            default: di = d - t; dj = -d;     break;
+        }
+    }
+
+public:
+    MobilityLayer() = default;
+
+    /**
+     * @brief No long-range contacts (the original model).
+     */
+    static MobilityLayer none() { return MobilityLayer(); }
+
+    /**
+     * @brief Contacts with uniformly random cells of the grid.
+     * @param rate Mean contacts per infected cell per day.
+     * @param transmission Probability that a contact infects a susceptible cell.
+     */
+    static MobilityLayer uniform(double rate, double transmission) {
+        MobilityLayer m;
+        m.configure(Kernel::Uniform, rate, transmission);
+        return m;
+    }
+
+    /**
+     * @brief Contacts at a power-law distributed distance from the source.
+     * @param rate Mean contacts per infected cell per day.
+     * @param transmission Probability that a contact infects a susceptible cell.
+     * @param exponent Exponent of the distance density d^-exponent; larger keeps travel shorter.
+     * @param maxDistance Largest Chebyshev distance; 0 uses the grid size.
+     */
+    static MobilityLayer powerLaw(double rate, double transmission, double exponent = 2.0, int maxDistance = 0) {
+        if (maxDistance < 0) throw std::invalid_argument("MobilityLayer::powerLaw: negative maximum distance");
+        MobilityLayer m;
+        m.configure(Kernel::PowerLaw, rate, transmission);
+        m._exponent = exponent;
+        m._maxDistance = maxDistance;
+        return m;
+    }
+
+    void configure(Kernel kernel, double rate, double transmission) {
+        if (!(rate >= 0.0)) throw std::invalid_argument("MobilityLayer: rate must be non-negative");
+        if (!(transmission >= 0.0 && transmission <= 1.0)) {
+            throw std::invalid_argument("MobilityLayer: transmission must be in [0, 1]");
+        }
+        _kernel = kernel;
+        _rate = rate;
+        _transmission = transmission;
+        _tableMax = 0;
+    }
+
+    bool enabled() const { return _kernel != Kernel::None && _rate * _transmission > 0.0; }
+    Kernel kernel() const { return _kernel; }
+    double rate() const { return _rate; }
+    double transmission() const { return _transmission; }
+
+    /**
+     * @brief Draws the day's transmitting remote contacts.
+     *
+     * Targets past the edge of the grid are mapped back by a periodic or reflecting boundary
+     * and lost under a closed one.
+     * @param infected Flat indices (i * n + j) of the infected cells at the start of the day.
+     * @param n Grid side length.
+     * @param boundary Boundary condition of the grid.
+     * @param gen Uniform random bit generator.
+     * @param visit Called with the flat index of each contacted cell; the caller infects it if
+     *        it is susceptible. A cell can be visited more than once.
+     * @param scale Multiplier of the contact rate. A caller with per-cell susceptibility passes
+     *        its largest value and keeps each visit with probability susceptibility / scale, so
+     *        a cell is infected at rate · transmission · its own susceptibility.
+     */
+    template <class Gen, class Visit>
+    void forEachContact(const std::vector<int>& infected, int n, Boundary boundary, Gen& gen, Visit&& visit,
+                        double scale = 1.0) {
+        if (!enabled() || infected.empty() || !(scale > 0.0)) return;
+        std::poisson_distribution<long long> contacts(_rate * _transmission * scale * static_cast<double>(infected.size()));
+        const long long count = contacts(gen);
+        if (count == 0) return;
+
+        std::uniform_int_distribution<std::size_t> source(0, infected.size() - 1);
+        if (_kernel == Kernel::Uniform) {
+            std::uniform_int_distribution<std::int64_t> cell(0, static_cast<std::int64_t>(n) * n - 1);
+            for (long long c = 0; c < count; ++c) visit(static_cast<int>(cell(gen)));
+            return;
+        }
+
+        const int maxDistance = _maxDistance > 0 ? _maxDistance : n;
+        if (_tableMax != maxDistance) buildDistances(maxDistance);
+        for (long long c = 0; c < count; ++c) {
+            const int from = infected[source(gen)];
+            const int d = static_cast<int>(_distances.sample(gen)) + 1;
+            std::uniform_int_distribution<int> onRing(0, 8 * d - 1);
+            int di, dj;
+            ringOffset(d, onRing(gen), di, dj);
+            int i = from / n + di, j = from % n + dj;
+            if (i < 0 || i >= n || j < 0 || j >= n) {
+                if (boundary == Boundary::Closed) continue;
+                i = boundaryIndex(i, n, boundary);
+                j = boundaryIndex(j, n, boundary);
+            }
+            visit(i * n + j);
+        }
+    }
+};
+
+#endif // MOBILITY_LAYER_HPP
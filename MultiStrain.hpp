@@ -0,0 +1,307 @@
+/**
+ * @file MultiStrain.hpp
+ * @brief Multi-strain SIRV model with cross-immunity, one packed byte per cell.
+ */
+
+#ifndef MULTI_STRAIN_HPP
+#define MULTI_STRAIN_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "Boundary.hpp"
+#include "CellState.hpp"
+#include "CounterRng.hpp"
+#include "PhaseTimer.hpp"
+#include "SirvRules.hpp"
+
+/**
+ * @brief Layout of the packed multi-strain cell byte.
+ *
+ *     bit  7     6     5 4     3 2 1 0
+ *        [vac] [inf] [strain] [immunity mask]
+ *
+ * The immunity mask has bit k set once the person has recovered from strain k; strain is the
+ * strain of the current infection and is meaningful only with the infected bit. Vaccinated
+ * people are immune to every strain and have no further transitions, so kVaccinated also
+ * pads the grid edge (it is never infected).
+ */
+struct StrainCode {
+    static constexpr std::uint8_t kMaskBits   = 0x0F;
+    static constexpr std::uint8_t kStrainBits = 0x30;
+    static constexpr int          kStrainShift = 4;
+    static constexpr std::uint8_t kInfected   = 0x40;
+    static constexpr std::uint8_t kVaccinated = 0x80;
+
+    static constexpr std::uint8_t infected(int strain, std::uint8_t mask) {
+        return static_cast<std::uint8_t>(kInfected | (strain << kStrainShift) | (mask & kMaskBits));
+    }
+    static constexpr bool isInfected(std::uint8_t c) { return (c & kInfected) != 0; }
+    static constexpr bool isVaccinated(std::uint8_t c) { return (c & kVaccinated) != 0; }
+    static constexpr int strain(std::uint8_t c) { return (c & kStrainBits) >> kStrainShift; }
+    static constexpr std::uint8_t mask(std::uint8_t c) { return c & kMaskBits; }
+};
+
+/**
+ * @class MultiStrainPopulation
+ * @brief K (up to 4) co-circulating strains on the SIRV grid, with partial cross-immunity.
+ *
+ * Per day, with one counterUniform draw per cell:
+ *  - an infected cell recovers with rate rr, adding its strain to its immunity mask;
+ *  - any other unvaccinated cell is infected by strain k with probability
+ *    (infected neighbors carrying k) · ri · susceptibility[mask][k], where the susceptibility
+ *    of a mask is the product over its strains j of (1 - crossImmunity[j][k]) and is a table
+ *    lookup; a cell with immunity then loses all of it with rate rm (the single-strain
+ *    "mutation"), and vaccination happens with rate rv as in Population::Update().
+ * The outcomes partition the uniform in that order, so with one strain and full homologous
+ * immunity the model is exactly the single-strain one. It is cell for cell identical to a
+ * Population with the same seed and boundary only when that Population is advanced one day
+ * per call (advance(1)): advance(k) with k > 1 decides the vaccination cap once for its whole
+ * block, while step() decides it every day. Under a periodic or reflecting boundary the match
+ * further rests on both classes filling their ghost cells through boundaryIndex(), so the
+ * edge handling of one cannot change without the other.
+ *
+ * The grid is two padded byte planes, so a step streams one byte per cell in and out like
+ * the single-strain kernels, and runs in parallel with OpenMP.
+ */
+class MultiStrainPopulation {
+public:
+    static constexpr int kMaxStrains = 4;
+
+    /**
+     * @brief Aggregate counts.
+     */
+    struct Counts {
+    std::int64_t naive = 0;                 /** <Never infected (or immunity lost), unvaccinated */
+    std::int64_t immune = 0;                /** <Not infected, immune to at least one strain */
+    std::int64_t vaccinated = 0;
+    std::int64_t infected[kMaxStrains] = {0, 0, 0, 0}; /** <Currently infected, per strain */
+    };
+
+private:
+    int _n;
+    int _strains;
+    std::uint64_t _seed;
+    SirvRates _rates;
+    Boundary _boundary;
+    int _t = 0;
+    std::vector<std::uint8_t> _plane; /** <Current codes, (n+2)×(n+2) with a one-cell halo */
+    std::vector<std::uint8_t> _next;  /** <Write buffer of step() */
+    float _cross[kMaxStrains][kMaxStrains];   /** <Immunity to strain k from past infection with strain j */
+    float _susceptibility[16][kMaxStrains];   /** <Susceptibility to strain k for each immunity mask */
+    std::int64_t _vaccinated = 0;             /** <Kept for the vaccination cap */
+    bool _haloStale = false;                  /** <Cells were set since the halo was filled */
+
+    std::size_t at(int i, int j) const { return static_cast<std::size_t>(i + 1) * (_n + 2) + (j + 1); }
+
+    void rebuildSusceptibility() {
+        for (int m = 0; m < 16; ++m) {
+            for (int k = 0; k < kMaxStrains; ++k) {
+                float s = 1.0f;
+                for (int j = 0; j < kMaxStrains; ++j) {
+                    if (m & (1 << j)) s *= 1.0f - _cross[j][k];
+                }
+                _susceptibility[m][k] = s;
+            }
+        }
+    }
+
+    /**
+     * @brief Fills the halo ring of plane p per the boundary condition.
+     */
+    void fillHalo(std::vector<std::uint8_t>& p) const {
+        const int w = _n + 2;
+        for (int i = -1; i <= _n; ++i) {
+            for (int j = -1; j <= _n; ++j) {
+                if (i >= 0 && i < _n && j >= 0 && j < _n) {
+                    j = _n - 1; //interior row: skip to the right-hand ring
+                    continue;
+                }
+                std::uint8_t v = StrainCode::kVaccinated;
+                if (_boundary != Boundary::Closed) {
+                    v = p[at(boundaryIndex(i, _n, _boundary), boundaryIndex(j, _n, _boundary))];
+                }
+                p[static_cast<std::size_t>(i + 1) * w + (j + 1)] = v;
+            }
+        }
+    }
+
+    void checkCell(int i, int j) const {
+        if (i < 0 || i >= _n || j < 0 || j >= _n) throw std::out_of_range("MultiStrainPopulation: cell out of range");
+    }
+
+    void store(int i, int j, std::uint8_t code) {
+        checkCell(i, j);
+        std::uint8_t& c = _plane[at(i, j)];
+        _vaccinated += StrainCode::isVaccinated(code) - StrainCode::isVaccinated(c);
+        c = code;
+        _haloStale = true;
+    }
+
+public:
+    /**
+     * @brief Creates an all-naive n×n grid.
+     * @param n Grid side length.
+     * @param strains Number of strains, 1 to kMaxStrains.
+     * @param seed Seed of the counter-based draws.
+     * @param rates Model rates, shared by all strains.
+     * @param boundary Boundary condition of the von Neumann neighborhood.
+     */
+    MultiStrainPopulation(int n, int strains, std::uint64_t seed, const SirvRates& rates = SirvRates{},
+                          Boundary boundary = Boundary::Closed)
+    : _n(n), _strains(strains), _seed(seed), _rates(rates), _boundary(boundary) {
+        if (n <= 0) throw std::invalid_argument("MultiStrainPopulation: n must be positive");
+        if (strains < 1 || strains > kMaxStrains) {
+            throw std::invalid_argument("MultiStrainPopulation: between 1 and 4 strains");
+        }
+        const std::size_t w = static_cast<std::size_t>(n) + 2;
+        _plane.assign(w * w, 0);
+        _next.assign(w * w, 0);
+        fillHalo(_plane);
+        for (int j = 0; j < kMaxStrains; ++j) {
+            for (int k = 0; k < kMaxStrains; ++k) _cross[j][k] = j == k ? 1.0f : 0.0f;
+        }
+        rebuildSusceptibility();
+    }
+
+    /**
+     * @brief Sets how much immunity a past infection with one strain gives against another.
+     * @param from Strain of the past infection.
+     * @param to Strain of the new exposure.
+     * @param immunity 0 (none) to 1 (full); by default 1 for the same strain and 0 otherwise.
+     */
+    void setCrossImmunity(int from, int to, float immunity) {
+        if (from < 0 || from >= _strains || to < 0 || to >= _strains) {
+            throw std::out_of_range("MultiStrainPopulation::setCrossImmunity: no such strain");
+        }
+        if (!(immunity >= 0.0f && immunity <= 1.0f)) {
+            throw std::invalid_argument("MultiStrainPopulation::setCrossImmunity: immunity must be in [0, 1]");
+        }
+        _cross[from][to] = immunity;
+        rebuildSusceptibility();
+    }
+
+    // Accessors
+    int size() const { return _n; }
+    int strains() const { return _strains; }
+    int day() const { return _t; }
+    std::uint8_t code(int i, int j) const { return _plane[at(i, j)]; }
+    float crossImmunity(int from, int to) const { return _cross[from][to]; }
+
+    /**
+     * @brief The cell seen through the single-strain states (any immunity counts as recovered).
+     */
+    CellState getState(int i, int j) const {
+        const std::uint8_t c = code(i, j);
+        if (StrainCode::isVaccinated(c)) return CellState::Vaccinated;
+        if (StrainCode::isInfected(c))   return CellState::Infected;
+        return StrainCode::mask(c) ? CellState::Recovered : CellState::Susceptible;
+    }
+
+    Counts countStates() const {
+        Counts c;
+        for (int i = 0; i < _n; ++i) {
+            const std::uint8_t* row = &_plane[at(i, 0)];
+            for (int j = 0; j < _n; ++j) {
+                const std::uint8_t v = row[j];
+                if (StrainCode::isVaccinated(v))    ++c.vaccinated;
+                else if (StrainCode::isInfected(v)) ++c.infected[StrainCode::strain(v)];
+                else if (StrainCode::mask(v))       ++c.immune;
+                else                                ++c.naive;
+            }
+        }
+        return c;
+    }
+
+    // Mutators
+    void infect(int i, int j, int strain) {
+        if (strain < 0 || strain >= _strains) throw std::out_of_range("MultiStrainPopulation::infect: no such strain");
+        store(i, j, StrainCode::infected(strain, StrainCode::mask(code(i, j))));
+    }
+    void setImmunity(int i, int j, std::uint8_t mask) { store(i, j, mask & ((1 << _strains) - 1)); }
+    void setNaive(int i, int j) { store(i, j, 0); }
+    void setVaccinated(int i, int j) { store(i, j, StrainCode::kVaccinated); }
+
+    /**
+     * @brief Advances one day.
+     */
+    void step() {
+        EPIDEMIC_PHASE("MultiStrainPopulation::step");
+        if (_haloStale) {
+            fillHalo(_plane);
+            _haloStale = false;
+        }
+        const int day = _t + 1;
+        const std::int64_t total = static_cast<std::int64_t>(_n) * _n;
+        const bool allow = vaccinationAllowed(_vaccinated, total, _rates);
+        const bool susVaccine = day >= _rates.tv && allow;
+        const bool recVaccine = day > _rates.tv && allow;
+        const std::uint64_t key = dayKey(_seed, static_cast<std::uint64_t>(day));
+        const std::ptrdiff_t w = _n + 2;
+        const int K = _strains;
+        const SirvRates r = _rates;
+        const std::uint8_t* src = _plane.data();
+        std::uint8_t* dst = _next.data();
+        std::int64_t vaccinated = 0;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(+ : vaccinated)
+#endif
+        for (int i = 0; i < _n; ++i) {
+            const std::uint8_t* row = src + (i + 1) * w + 1;
+            std::uint8_t* out = dst + (i + 1) * w + 1;
+            for (int j = 0; j < _n; ++j) {
+                const std::uint8_t c = row[j];
+                const float seed = counterUniform(key, static_cast<std::uint64_t>(i) * _n + j);
+                std::uint8_t next = c;
+                if (StrainCode::isVaccinated(c)) {
+                    //no transitions
+                } else if (StrainCode::isInfected(c)) {
+                    if (seed < r.rr) next = static_cast<std::uint8_t>((c & StrainCode::kMaskBits) | (1 << StrainCode::strain(c)));
+                } else {
+                    const std::uint8_t mask = StrainCode::mask(c);
+                    const std::uint8_t nb[4] = {row[j - w], row[j + w], row[j - 1], row[j + 1]};
+                    int exposed[kMaxStrains] = {0, 0, 0, 0};
+                    for (std::uint8_t v : nb) exposed[StrainCode::strain(v)] += StrainCode::isInfected(v);
+                    //one uniform, partitioned: infection by each strain, then waning, then vaccination
+                    float edge = 0.0f;
+                    bool done = false;
+                    for (int k = 0; k < K && !done; ++k) {
+                        const float p = exposed[k] * r.ri * _susceptibility[mask][k];
+                        if (seed < edge + p) {
+                            next = StrainCode::infected(k, mask);
+                            done = true;
+                        }
+                        edge += p;
+                    }
+                    if (!done && mask) {
+                        if (seed < edge + r.rm) {
+                            next = 0;
+                            done = true;
+                        }
+                        edge += r.rm;
+                    }
+                    const bool vaccine = mask ? recVaccine : susVaccine;
+                    if (!done && vaccine && edge < seed && seed < edge + r.rv) next = StrainCode::kVaccinated;
+                }
+                out[j] = next;
+                vaccinated += StrainCode::isVaccinated(next);
+            }
+        }
+
+        _plane.swap(_next);
+        fillHalo(_plane);
+        _vaccinated = vaccinated;
+        _t = day;
+    }
+
+    /**
+     * @brief Advances k days.
+     */
+    void advance(int k) {
+        for (int s = 0; s < k; ++s) step();
+    }
+};
+
+#endif // MULTI_STRAIN_HPP
@@ -0,0 +1,181 @@
+/**
+ * @file Neighborhood.hpp
+ * @brief Infection neighborhoods (von Neumann, Moore, radius-r, distance-weighted) and the
+ *        summed-area table that evaluates them in O(1) per box.
+ */
+
+#ifndef NEIGHBORHOOD_HPP
+#define NEIGHBORHOOD_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+#include "CellState.hpp"
+
+/**
+ * @class Neighborhood
+ * @brief Which cells can infect a susceptible cell, and with what weight.
+ *
+ * Apart from the default von Neumann stencil (the four edge neighbors, as in the original
+ * model), a neighborhood is a stack of nested square boxes centered on the cell: a layer
+ * {radius, weight} adds weight for every infected cell within Chebyshev distance radius.
+ * Stacking boxes gives a piecewise-constant kernel in Chebyshev distance, and each box is one
+ * O(1) summed-area-table query, so the cost per cell depends on the number of layers, not on
+ * the radius.
+ */
+class Neighborhood {
+public:
+    /**
+     * @brief One nested box of the kernel.
+     */
+    struct Layer {
+        int radius;   /** <Chebyshev radius of the box */
+        float weight; /** <Weight added per infected cell inside the box */
+    };
+
+private:
+    bool _vonNeumann = true;    /** <The original four-neighbor stencil */
+    std::vector<Layer> _layers; /** <Nested boxes, by increasing radius */
+
+public:
+    /**
+     * @brief The four edge neighbors, each with weight 1 (the original model).
+     */
+    static Neighborhood vonNeumann() { return Neighborhood(); }
+
+    /**
+     * @brief All cells within Chebyshev distance r, each with weight 1; r = 1 is the 8-cell Moore neighborhood.
+     * @param r Radius, at least 1.
+     */
+    static Neighborhood moore(int r = 1) {
+        if (r < 1) throw std::invalid_argument("Neighborhood::moore: radius must be at least 1");
+        Neighborhood nb;
+        nb._vonNeumann = false;
+        nb._layers.push_back(Layer{r, 1.0f});
+        return nb;
+    }
+
+    /**
+     * @brief A distance-weighted kernel out to radius r.
+     *
+     * kernel(d) gives the weight of an infected cell at Chebyshev distance d (1 <= d <= r). The
+     * distances are split into at most maxLayers equal bands and the kernel is averaged over
+     * each band, so evaluation costs maxLayers box queries however large r is.
+     * @param r Radius, at least 1.
+     * @param kernel Weight as a function of Chebyshev distance.
+     * @param maxLayers Maximum number of nested boxes.
+     */
+    static Neighborhood distanceWeighted(int r, const std::function<float(int)>& kernel, int maxLayers = 8) {
+        if (r < 1) throw std::invalid_argument("Neighborhood::distanceWeighted: radius must be at least 1");
+        if (maxLayers < 1) throw std::invalid_argument("Neighborhood::distanceWeighted: need at least one layer");
+        const int bands = std::min(r, maxLayers);
+        std::vector<int> outer(bands);
+        std::vector<float> value(bands);
+        int d0 = 1;
+        for (int b = 0; b < bands; ++b) {
+            int d1 = static_cast<int>((static_cast<long long>(r) * (b + 1)) / bands);
+            float sum = 0.0f;
+            for (int d = d0; d <= d1; ++d) sum += kernel(d);
+            outer[b] = d1;
+            value[b] = sum / (d1 - d0 + 1);
+            d0 = d1 + 1;
+        }
+        //box b adds value[b] - value[b+1], so a cell in band m receives sum_{b >= m} = value[m]
+        Neighborhood nb;
+        nb._vonNeumann = false;
+        for (int b = 0; b < bands; ++b) {
+            float next = b + 1 < bands ? value[b + 1] : 0.0f;
+            if (value[b] != next) nb._layers.push_back(Layer{outer[b], value[b] - next});
+        }
+        return nb;
+    }
+
+    /**
+     * @brief A custom stack of boxes.
+     * @param layers Boxes with radius >= 1.
+     */
+    static Neighborhood boxes(std::vector<Layer> layers) {
+        for (const Layer& l : layers) {
+            if (l.radius < 1) throw std::invalid_argument("Neighborhood::boxes: radius must be at least 1");
+        }
+        Neighborhood nb;
+        nb._vonNeumann = false;
+        nb._layers = std::move(layers);
+        return nb;
+    }
+
+    bool isVonNeumann() const { return _vonNeumann; }
+    const std::vector<Layer>& layers() const { return _layers; }
+
+    /**
+     * @brief Largest distance at which a cell can be infected.
+     */
+    int radius() const {
+        int r = 1;
+        for (const Layer& l : _layers) r = std::max(r, l.radius);
+        return r;
+    }
+};
+
+/**
+ * @class InfectedSums
+ * @brief Summed-area table of the infected indicator, for O(1) infected counts over any box.
+ *
+ * It is built over a square plane of CellState codes, normally the grid plus its halo ring,
+ * so boxes reaching past the grid edge see whatever the boundary condition put there.
+ * Counts are 32-bit, which is enough for planes up to 46340×46340.
+ */
+class InfectedSums {
+private:
+    int _w = 0;
+    std::vector<std::int32_t> _sat; /** <(w+1)×(w+1) prefix sums; row and column 0 are zero */
+
+    std::int32_t at(int i, int j) const { return _sat[static_cast<std::size_t>(i) * (_w + 1) + j]; }
+
+public:
+    /**
+     * @brief Rebuilds the table; the storage is reused between calls.
+     * @param codes Row-major w×w plane of CellState codes (other values count as not infected).
+     * @param w Side length of the plane.
+     */
+    void build(const std::vector<std::uint8_t>& codes, int w) {
+        constexpr std::uint8_t I = static_cast<std::uint8_t>(CellState::Infected);
+        _w = w;
+        _sat.assign(static_cast<std::size_t>(w + 1) * (w + 1), 0);
+        for (int i = 0; i < w; ++i) {
+            std::int32_t rowSum = 0;
+            const std::uint8_t* in = &codes[static_cast<std::size_t>(i) * w];
+            std::int32_t* above = &_sat[static_cast<std::size_t>(i) * (w + 1)];
+            std::int32_t* row = above + (w + 1);
+            for (int j = 0; j < w; ++j) {
+                rowSum += in[j] == I;
+                row[j + 1] = above[j + 1] + rowSum;
+            }
+        }
+    }
+
+    /**
+     * @brief Infected cells within Chebyshev distance r of plane cell (i, j), clipped to the plane.
+     */
+    std::int32_t boxCount(int i, int j, int r) const {
+        const int i0 = std::max(i - r, 0), i1 = std::min(i + r + 1, _w);
+        const int j0 = std::max(j - r, 0), j1 = std::min(j + r + 1, _w);
+        return at(i1, j1) - at(i0, j1) - at(i1, j0) + at(i0, j0);
+    }
+
+    /**
+     * @brief Weighted infected count around plane cell (i, j) for a box-stack neighborhood.
+     *
+     * The cell itself is inside every box; callers evaluate it for susceptible cells only,
+     * where it contributes nothing.
+     */
+    float pressure(int i, int j, const Neighborhood& nb) const {
+        float p = 0.0f;
+        for (const Neighborhood::Layer& l : nb.layers()) p += l.weight * boxCount(i, j, l.radius);
+        return p;
+    }
+};
+
+#endif // NEIGHBORHOOD_HPP
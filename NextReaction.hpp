@@ -0,0 +1,367 @@
+/**
+ * @file NextReaction.hpp
+ * @brief Continuous-time (event-driven) S/I/R/V engine using the next-reaction method.
+ */
+
+#ifndef NEXT_REACTION_HPP
+#define NEXT_REACTION_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "Boundary.hpp"
+#include "CellState.hpp"
+#include "PhaseTimer.hpp"
+#include "SirvRules.hpp"
+
+/**
+ * @class IndexedMinHeap
+ * @brief Binary min-heap of (time, rate, item) entries with a position index, so the entry of
+ *        any item can be found, changed or removed in O(log size).
+ */
+class IndexedMinHeap {
+public:
+    struct Entry {
+        double time;       /** <Putative firing time */
+        double rate;       /** <Propensity the time was drawn for */
+        std::int32_t item; /** <Cell index */
+    };
+
+private:
+    std::vector<Entry> _heap;
+    std::vector<std::int32_t> _pos; /** <Heap slot of each item, -1 when absent */
+
+    void place(std::size_t k, const Entry& e) {
+        _heap[k] = e;
+        _pos[e.item] = static_cast<std::int32_t>(k);
+    }
+
+    void siftUp(std::size_t k) {
+        Entry e = _heap[k];
+        while (k > 0) {
+            std::size_t parent = (k - 1) / 2;
+            if (_heap[parent].time <= e.time) break;
+            place(k, _heap[parent]);
+            k = parent;
+        }
+        place(k, e);
+    }
+
+    void siftDown(std::size_t k) {
+        Entry e = _heap[k];
+        const std::size_t size = _heap.size();
+        while (true) {
+            std::size_t child = 2 * k + 1;
+            if (child >= size) break;
+            if (child + 1 < size && _heap[child + 1].time < _heap[child].time) ++child;
+            if (e.time <= _heap[child].time) break;
+            place(k, _heap[child]);
+            k = child;
+        }
+        place(k, e);
+    }
+
+public:
+    /**
+     * @brief Empties the heap and sizes the index for items 0 .. items-1.
+     */
+    void reset(std::size_t items) {
+        _heap.clear();
+        _pos.assign(items, -1);
+    }
+
+    bool empty() const { return _heap.empty(); }
+    std::size_t size() const { return _heap.size(); }
+    const Entry& top() const { return _heap.front(); }
+    bool contains(std::int32_t item) const { return _pos[item] >= 0; }
+    const Entry& entry(std::int32_t item) const { return _heap[_pos[item]]; }
+
+    /**
+     * @brief Inserts an item, or moves it if already present.
+     */
+    void set(const Entry& e) {
+        if (contains(e.item)) {
+            std::size_t k = _pos[e.item];
+            double old = _heap[k].time;
+            _heap[k] = e;
+            if (e.time < old) siftUp(k);
+            else              siftDown(k);
+            return;
+        }
+        _heap.push_back(e);
+        siftUp(_heap.size() - 1);
+    }
+
+    void remove(std::int32_t item) {
+        std::size_t k = _pos[item];
+        _pos[item] = -1;
+        Entry last = _heap.back();
+        _heap.pop_back();
+        if (k == _heap.size()) return;
+        place(k, last);
+        siftUp(k);
+        siftDown(_pos[last.item]);
+    }
+};
+
+/**
+ * @class NextReactionEngine
+ * @brief The SIRV grid model in continuous time, simulated one event at a time.
+ *
+ * Each per-day probability p of the discrete model becomes the hazard -ln(1 - p), which gives
+ * the same chance of the event within one day when nothing else changes: an infected von
+ * Neumann neighbor contributes -ln(1 - ri), recovery is -ln(1 - rr), mutation -ln(1 - rm) and
+ * vaccination -ln(1 - rv). Every cell with a non-zero total hazard holds an exponential
+ * firing time in an indexed priority queue (Gibson and Bruck's next-reaction method): the
+ * earliest cell fires, the channel is chosen in proportion to its hazards, and only that cell
+ * and its four neighbors are re-timed, rescaling their existing times when their hazard
+ * changes so no random number is wasted. The cost is O(log queue) per event, and cells with
+ * nothing to do (susceptible cells away from infection before the vaccine, recovered cells
+ * once vaccinated...) are never touched.
+ *
+ * The vaccine becomes available at the start of day tv (time tv - 1, when the discrete
+ * engine's step tv begins), for susceptible and recovered cells alike, and is withdrawn the
+ * moment the vaccinated fraction reaches 1 - rvh; both are global events that re-time every
+ * cell once. Grids up to 46340×46340 (32-bit cell indices).
+ */
+class NextReactionEngine {
+public:
+    /**
+     * @brief Aggregate counts of each state.
+     */
+    struct Counts {
+    std::int64_t susceptible = 0;
+    std::int64_t infected = 0;
+    std::int64_t recovered = 0;
+    std::int64_t vaccinated = 0;
+    };
+
+private:
+    int _n;
+    SirvRates _rates;
+    Boundary _boundary;
+    std::mt19937_64 _gen;
+    std::vector<std::uint8_t> _state; /** <CellState code per cell, row-major */
+    std::int64_t _counts[4] = {0, 0, 0, 0};
+    IndexedMinHeap _queue;
+    double _time = 0.0;               /** <Current simulation time, in days */
+    std::uint64_t _events = 0;        /** <Transitions fired so far */
+    bool _vaccine = false;            /** <Whether vaccination hazards are currently on */
+    bool _vaccineOpened = false;      /** <Whether the vaccine-availability event has happened */
+    bool _stale = true;               /** <States were set directly; every cell needs re-timing */
+
+    // hazards per day
+    double _hInfect, _hRecover, _hMutate, _hVaccinate;
+
+    static double hazard(float p) {
+        if (p <= 0.0f) return 0.0;
+        return -std::log1p(-std::min(static_cast<double>(p), 1.0 - 1e-12));
+    }
+
+    double vaccineStart() const { return static_cast<double>(_rates.tv) - 1.0; }
+
+    bool capReached() const {
+        return !vaccinationAllowed(_counts[3], static_cast<std::int64_t>(_n) * _n, _rates);
+    }
+
+    /**
+     * @brief Index of the neighbor of cell (i, j) at offset (di, dj), or -1 outside a closed grid.
+     */
+    std::int32_t neighbor(int i, int j, int di, int dj) const {
+        int a = i + di, b = j + dj;
+        if (a < 0 || a >= _n || b < 0 || b >= _n) {
+            if (_boundary == Boundary::Closed) return -1;
+            a = boundaryIndex(a, _n, _boundary);
+            b = boundaryIndex(b, _n, _boundary);
+        }
+        return a * _n + b;
+    }
+
+    int infectedNeighbors(std::int32_t c) const {
+        constexpr std::uint8_t I = static_cast<std::uint8_t>(CellState::Infected);
+        const int i = c / _n, j = c % _n;
+        int k = 0;
+        const int di[4] = {-1, 1, 0, 0}, dj[4] = {0, 0, -1, 1};
+        for (int d = 0; d < 4; ++d) {
+            std::int32_t m = neighbor(i, j, di[d], dj[d]);
+            k += m >= 0 && _state[m] == I;
+        }
+        return k;
+    }
+
+    /**
+     * @brief Total hazard of cell c; infection is set to the part that leads to infection.
+     */
+    double propensity(std::int32_t c, double& infection) const {
+        infection = 0.0;
+        const double vac = _vaccine ? _hVaccinate : 0.0;
+        switch (static_cast<CellState>(_state[c])) {
+            case CellState::Susceptible:
+                infection = infectedNeighbors(c) * _hInfect;
+                return infection + vac;
+            case CellState::Infected:
+                return _hRecover;
+            case CellState::Recovered:
+                return _hMutate + vac;
+            default:
+                return 0.0;
+        }
+    }
+
+    double exponential(double rate) {
+        std::uniform_real_distribution<double> dis(0.0, 1.0);
+        return -std::log(1.0 - dis(_gen)) / rate;
+    }
+
+    /**
+     * @brief Re-times cell c after its hazard may have changed.
+     */
+    void retime(std::int32_t c) {
+        double infection;
+        const double a = propensity(c, infection);
+        if (!_queue.contains(c)) {
+            if (a > 0.0) _queue.set({_time + exponential(a), a, c});
+            return;
+        }
+        if (a <= 0.0) {
+            _queue.remove(c);
+            return;
+        }
+        IndexedMinHeap::Entry e = _queue.entry(c);
+        if (e.rate == a) return;
+        //next-reaction rescaling: the remaining exponential time scales by old / new hazard
+        e.time = _time + (e.rate / a) * (e.time - _time);
+        e.rate = a;
+        _queue.set(e);
+    }
+
+    void retimeAll() {
+        for (std::int32_t c = 0; c < static_cast<std::int32_t>(_state.size()); ++c) retime(c);
+        _stale = false;
+    }
+
+    void setCode(std::int32_t c, CellState s) {
+        --_counts[_state[c]];
+        _state[c] = static_cast<std::uint8_t>(s);
+        ++_counts[_state[c]];
+    }
+
+    /**
+     * @brief Fires the earliest cell and re-times it and its neighbors.
+     */
+    void fire() {
+        const IndexedMinHeap::Entry e = _queue.top();
+        const std::int32_t c = e.item;
+        _time = e.time;
+        _queue.remove(c);
+
+        double infection;
+        const double a = propensity(c, infection);
+        std::uniform_real_distribution<double> dis(0.0, 1.0);
+        const double u = dis(_gen) * a;
+        switch (static_cast<CellState>(_state[c])) {
+            case CellState::Susceptible:
+                setCode(c, u < infection ? CellState::Infected : CellState::Vaccinated);
+                break;
+            case CellState::Infected:
+                setCode(c, CellState::Recovered);
+                break;
+            case CellState::Recovered:
+                setCode(c, u < _hMutate ? CellState::Susceptible : CellState::Vaccinated);
+                break;
+            default:
+                break;
+        }
+        ++_events;
+
+        if (_vaccine && _state[c] == static_cast<std::uint8_t>(CellState::Vaccinated) && capReached()) {
+            _vaccine = false;
+            retimeAll();
+            return;
+        }
+        retime(c);
+        const int i = c / _n, j = c % _n;
+        const int di[4] = {-1, 1, 0, 0}, dj[4] = {0, 0, -1, 1};
+        for (int d = 0; d < 4; ++d) {
+            std::int32_t m = neighbor(i, j, di[d], dj[d]);
+            if (m >= 0) retime(m);
+        }
+    }
+
+public:
+    /**
+     * @brief Creates an all-susceptible n×n grid at time 0.
+     * @param n Grid side length.
+     * @param seed Seed of the event times.
+     * @param rates Per-day rates of the discrete model.
+     * @param boundary Boundary condition of the von Neumann neighborhood.
+     */
+    NextReactionEngine(int n, std::uint64_t seed, const SirvRates& rates = SirvRates{},
+                       Boundary boundary = Boundary::Closed)
+    : _n(n), _rates(rates), _boundary(boundary), _gen(seed),
+      _state(static_cast<std::size_t>(n) * n, static_cast<std::uint8_t>(CellState::Susceptible)) {
+        if (n <= 0 || n > 46340) throw std::invalid_argument("NextReactionEngine: n must be in [1, 46340]");
+        _counts[0] = static_cast<std::int64_t>(n) * n;
+        _hInfect    = hazard(rates.ri);
+        _hRecover   = hazard(rates.rr);
+        _hMutate    = hazard(rates.rm);
+        _hVaccinate = hazard(rates.rv);
+        _queue.reset(_state.size());
+    }
+
+    // Accessors
+    int size() const { return _n; }
+    double time() const { return _time; }
+    std::uint64_t events() const { return _events; }
+    std::size_t pending() const { return _queue.size(); }
+    CellState getState(int i, int j) const { return static_cast<CellState>(_state[static_cast<std::size_t>(i) * _n + j]); }
+
+    Counts countStates() const {
+        Counts c;
+        c.susceptible = _counts[0];
+        c.infected    = _counts[1];
+        c.recovered   = _counts[2];
+        c.vaccinated  = _counts[3];
+        return c;
+    }
+
+    // Mutators
+    void setState(int i, int j, CellState s) {
+        setCode(static_cast<std::int32_t>(i * _n + j), s);
+        _stale = true;
+    }
+
+    /**
+     * @brief Fires every event up to time t (in days) and leaves the clock at t.
+     */
+    void advanceTo(double t) {
+        EPIDEMIC_PHASE("NextReactionEngine::advanceTo");
+        if (_stale) retimeAll();
+        while (true) {
+            const double next = _queue.empty() ? std::numeric_limits<double>::infinity() : _queue.top().time;
+            //the vaccine opening is a global event scheduled at a fixed time
+            const double open = vaccineStart();
+            if (!_vaccineOpened && open <= std::min(next, t)) {
+                _vaccineOpened = true;
+                _time = std::max(_time, open);
+                _vaccine = !capReached();
+                if (_vaccine) retimeAll();
+                continue;
+            }
+            if (next > t) break;
+            fire();
+        }
+        _time = t;
+    }
+
+    /**
+     * @brief Advances the clock by the given number of days.
+     */
+    void advance(double days) { advanceTo(_time + days); }
+};
+
+#endif // NEXT_REACTION_HPP
@@ -0,0 +1,267 @@
+/**
+ * @file PhaseTimer.hpp
+ * @brief Low-overhead scoped timers that accumulate per-phase samples and summarize them.
+ */
+
+#ifndef PHASE_TIMER_HPP
+#define PHASE_TIMER_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Trace.hpp"
+
+/**
+ * @class PhaseTimings
+ * @brief Registry of named phases, each holding running statistics of its durations.
+ *
+ * Phases are registered once per call site (see EPIDEMIC_PHASE) and then recorded by index.
+ * Recording takes no lock: each phase keeps its count, total, minimum and maximum in atomics,
+ * and a fixed-size reservoir sample (Algorithm R) of durations for the percentiles, so memory
+ * stays bounded however long the run and however many threads record. Percentiles are exact
+ * until a phase has run kReservoir times and estimates from a uniform sample after that.
+ */
+class PhaseTimings {
+public:
+    static constexpr std::size_t kMaxPhases = 64;   /** <Further names share the last slot */
+    static constexpr std::size_t kReservoir = 512;  /** <Durations kept per phase for percentiles */
+
+private:
+    struct Phase {
+        std::string name;                               /** <Phase name as shown in the report */
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::uint64_t> totalNs{0};
+        std::atomic<std::uint64_t> minNs{UINT64_MAX};
+        std::atomic<std::uint64_t> maxNs{0};
+        std::array<std::atomic<std::uint64_t>, kReservoir> reservoir{}; /** <Sampled durations, ns */
+    };
+
+    std::array<Phase, kMaxPhases> _phases;
+    std::atomic<std::size_t> _registered{0};
+    mutable std::mutex _mutex; /** <Serializes registration only */
+    bool _enabled = true;
+
+    /**
+     * @brief Value at quantile q of an already sorted sample vector (nearest rank).
+     */
+    static double quantile(const std::vector<double>& sorted, double q) {
+        if (sorted.empty()) return 0.0;
+        std::size_t k = static_cast<std::size_t>(q * (sorted.size() - 1) + 0.5);
+        return sorted[std::min(k, sorted.size() - 1)];
+    }
+
+    /**
+     * @brief Per-thread generator for reservoir slots (xorshift64).
+     */
+    static std::uint64_t nextRandom() {
+        thread_local std::uint64_t state =
+            0x9E3779B97F4A7C15ull ^ std::hash<std::thread::id>{}(std::this_thread::get_id());
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+public:
+    /**
+     * @brief Summary statistics of one phase, in seconds.
+     */
+    struct Summary {
+        std::string name;
+        std::size_t count = 0;
+        double total = 0.0;
+        double mean = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+        double p50 = 0.0;
+        double p99 = 0.0;
+    };
+
+    /**
+     * @brief The process-wide registry used by EPIDEMIC_PHASE.
+     */
+    static PhaseTimings& global() {
+        static PhaseTimings timings;
+        return timings;
+    }
+
+    bool enabled() const { return _enabled; }
+    void setEnabled(bool on) { _enabled = on; }
+
+    /**
+     * @brief Returns the index of the phase with this name, registering it if needed.
+     * @param name Phase name.
+     */
+    std::size_t phaseId(const std::string& name) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const std::size_t registered = _registered.load(std::memory_order_relaxed);
+        for (std::size_t k = 0; k < registered; ++k) {
+            if (_phases[k].name == name) return k;
+        }
+        if (registered == kMaxPhases) return kMaxPhases - 1;
+        _phases[registered].name = registered + 1 == kMaxPhases ? "(other phases)" : name;
+        _registered.store(registered + 1, std::memory_order_release);
+        return registered;
+    }
+
+    /**
+     * @brief Adds one duration sample to a phase; lock-free and safe from any thread.
+     * @param id Index from phaseId().
+     * @param seconds Duration.
+     */
+    void record(std::size_t id, double seconds) {
+        Phase& p = _phases[id];
+        const std::uint64_t ns = static_cast<std::uint64_t>(std::max(seconds, 0.0) * 1e9 + 0.5);
+        const std::uint64_t n = p.count.fetch_add(1, std::memory_order_relaxed);
+        p.totalNs.fetch_add(ns, std::memory_order_relaxed);
+        std::uint64_t seen = p.minNs.load(std::memory_order_relaxed);
+        while (ns < seen && !p.minNs.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {}
+        seen = p.maxNs.load(std::memory_order_relaxed);
+        while (ns > seen && !p.maxNs.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {}
+        //Algorithm R: the (n+1)-th sample replaces a random slot with probability kReservoir / (n+1)
+        const std::uint64_t slot = n < kReservoir ? n : nextRandom() % (n + 1);
+        if (slot < kReservoir) p.reservoir[slot].store(ns, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Summaries of every phase that ran at least once, in registration order.
+     */
+    std::vector<Summary> summarize() const {
+        std::vector<Summary> out;
+        const std::size_t registered = _registered.load(std::memory_order_acquire);
+        for (std::size_t k = 0; k < registered; ++k) {
+            const Phase& p = _phases[k];
+            const std::uint64_t count = p.count.load(std::memory_order_relaxed);
+            if (count == 0) continue;
+            std::vector<double> sorted(static_cast<std::size_t>(std::min<std::uint64_t>(count, kReservoir)));
+            for (std::size_t r = 0; r < sorted.size(); ++r) {
+                sorted[r] = p.reservoir[r].load(std::memory_order_relaxed) * 1e-9;
+            }
+            std::sort(sorted.begin(), sorted.end());
+            Summary s;
+            s.name = p.name;
+            s.count = static_cast<std::size_t>(count);
+            s.total = p.totalNs.load(std::memory_order_relaxed) * 1e-9;
+            s.mean = s.total / s.count;
+            s.min = p.minNs.load(std::memory_order_relaxed) * 1e-9;
+            s.max = p.maxNs.load(std::memory_order_relaxed) * 1e-9;
+            s.p50 = quantile(sorted, 0.50);
+            s.p99 = quantile(sorted, 0.99);
+            out.push_back(s);
+        }
+        return out;
+    }
+
+    /**
+     * @brief Prints a table with count, total, mean, p50, p99 and max (milliseconds) per phase.
+     */
+    void report(std::ostream& os) const {
+        std::vector<Summary> phases = summarize();
+        if (phases.empty()) return;
+        os << "\nPhase timings (ms)\n"
+           << std::left << std::setw(34) << "phase"
+           << std::right << std::setw(8) << "count"
+           << std::setw(12) << "total"
+           << std::setw(10) << "mean"
+           << std::setw(10) << "p50"
+           << std::setw(10) << "p99"
+           << std::setw(10) << "max" << "\n";
+        for (const Summary& s : phases) {
+            os << std::left << std::setw(34) << s.name
+               << std::right << std::setw(8) << s.count
+               << std::fixed << std::setprecision(3)
+               << std::setw(12) << s.total * 1e3
+               << std::setw(10) << s.mean * 1e3
+               << std::setw(10) << s.p50 * 1e3
+               << std::setw(10) << s.p99 * 1e3
+               << std::setw(10) << s.max * 1e3 << "\n";
+        }
+    }
+
+    /**
+     * @brief Writes the summaries as JSON (seconds).
+     * @param path Output file.
+     * @return false if the file could not be written.
+     */
+    bool writeJson(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) return false;
+        std::vector<Summary> phases = summarize();
+        out << "{\n  \"phases\": [\n";
+        for (std::size_t k = 0; k < phases.size(); ++k) {
+            const Summary& s = phases[k];
+            out << "    {\"name\": \"" << s.name << "\", \"count\": " << s.count
+                << ", \"total\": " << s.total << ", \"mean\": " << s.mean
+                << ", \"min\": " << s.min << ", \"max\": " << s.max
+                << ", \"p50\": " << s.p50 << ", \"p99\": " << s.p99 << "}"
+                << (k + 1 < phases.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+        return static_cast<bool>(out);
+    }
+};
+
+/**
+ * @class ScopedPhase
+ * @brief Records the lifetime of the enclosing scope as one sample of a phase, and as a
+ *        trace span when the Tracer is enabled.
+ */
+class ScopedPhase {
+private:
+    using clock = std::chrono::steady_clock;
+    std::size_t _id;
+    const char* _name;
+    bool _timed;
+    bool _traced;
+    clock::time_point _start;
+
+public:
+    ScopedPhase(std::size_t id, const char* name)
+    : _id(id), _name(name),
+      _timed(PhaseTimings::global().enabled()), _traced(Tracer::global().enabled()) {
+        if (_timed || _traced) _start = clock::now();
+    }
+
+    ScopedPhase(const ScopedPhase&) = delete;
+    ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+    ~ScopedPhase() {
+        if (!_timed && !_traced) return;
+        clock::time_point end = clock::now();
+        if (_timed) {
+            PhaseTimings::global().record(_id, std::chrono::duration<double>(end - _start).count());
+        }
+        if (_traced) Tracer::global().record(_name, _start, end);
+    }
+};
+
+#define EPIDEMIC_PHASE_CONCAT2(a, b) a##b
+#define EPIDEMIC_PHASE_CONCAT(a, b) EPIDEMIC_PHASE_CONCAT2(a, b)
+
+/**
+ * @brief Times the rest of the enclosing scope under the given phase name (a string literal).
+ *
+ * The name is looked up once per call site. Define EPIDEMIC_NO_TIMINGS to compile the timers
+ * (and the trace spans they emit) out.
+ */
+#ifdef EPIDEMIC_NO_TIMINGS
+#define EPIDEMIC_PHASE(name) ((void)0)
+#else
+#define EPIDEMIC_PHASE(name)                                                                   \
+    static const std::size_t EPIDEMIC_PHASE_CONCAT(_phaseId, __LINE__) =                       \
+        PhaseTimings::global().phaseId(name);                                                  \
+    ScopedPhase EPIDEMIC_PHASE_CONCAT(_phaseScope, __LINE__)(EPIDEMIC_PHASE_CONCAT(_phaseId, __LINE__), name)
+#endif
+
+#endif // PHASE_TIMER_HPP
@@ -6,7 +6,22 @@
 #include "Person.hpp"
 #include <string>
 #include <random>
-#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include "GeometricSkipSampler.hpp"
+#include "Tiling.hpp"
+#include "CellState.hpp"
+#include "CounterRng.hpp"
+#include "SirvRules.hpp"
+#include "PhaseTimer.hpp"
+#include "Neighborhood.hpp"
+#include "Boundary.hpp"
+#include "RatePlanes.hpp"
+#include "MobilityLayer.hpp"
+#include "InfectiousPeriod.hpp"
 
 
 /**
@@ -14,6 +29,17 @@
  * @brief Represents an n×n matrix of People among which disease spread will be modeled.
  */
 class Population {
+public:
+    /**
+    * @brief Aggregate counts of each epidemiological state in the grid.
+    */
+    struct Counts {
+    int susceptible = 0;
+    int infected = 0;
+    int recovered = 0;
+    int vaccinated = 0;
+    };
+
 private:
     std::vector<std::vector<Person>> _m;  /** <The n*n matrix m which holds elements of type Person */
     int _n; /** <This represents that the matrix is n*n */
@@ -24,39 +50,265 @@ private:
     float _rvh = 0.2;          // vaccine hesitancy rate
     int _t = 0; /* <This represents the number of days elapsed*/
     int _tv = 200; /* <This represents the number of days until the vaccine is available*/
+    int _tile = 0; /* <Side length of the square tiles Update() walks the grid in; 0 means plain row-major*/
+    bool _autoTile = false; /* <Size the tiles from the cache and the bytes the sweep streams per cell*/
+    std::uint64_t _seed; /* <Seed of both the sequential generator and the counter-based draws of advance()*/
+    std::mt19937_64 _gen; /* <Generator used by Update()*/
+    Neighborhood _neighborhood; /* <Who can infect whom; von Neumann unless set otherwise*/
+    InfectedSums _sums; /* <Summed-area table of infected cells, rebuilt each step for box neighborhoods*/
+    Boundary _boundary = Boundary::Closed; /* <What lies beyond the grid edge*/
+    std::vector<std::uint8_t> _halo; /* <Start-of-step CellState codes of the grid plus a halo ring, filled per the boundary*/
+    int _haloWidth = 1; /* <Width of the halo ring: the neighborhood radius*/
+    RatePlane _susceptibility; /* <Per-cell multiplier of the infection rate; empty for the homogeneous model*/
+    RatePlane _recovery; /* <Per-cell multiplier of the recovery rate*/
+    RatePlane _hesitancy; /* <Per-cell probability of turning down a vaccination*/
+    MobilityLayer _mobility; /* <Long-range contacts; none unless set*/
+    std::vector<std::uint8_t> _age; /* <Days each cell has spent in its current state, saturating at 255; empty unless tracked*/
+    InfectiousPeriod _period = InfectiousPeriod::geometric(1.0f/20.0f); /* <Recovery probability by days infected, when ages are tracked*/
 
-/**
- * @brief Map a state string to a display color.
- * @param s State string: "susceptible", "infected", "recovered", or "vaccinated".
- * @return A  @c sf::Color for the given state; light gray if unknown.
- */
-    sf::Color colorForState(const std::string& s) const {
-    // match the example’s pastel palette
-    if (s == "infected")   return sf::Color(255, 182, 193); //  pink
-    if (s == "recovered")  return sf::Color(173, 216, 230); //  blue
-    if (s == "susceptible") return sf::Color(255, 239, 186); //  yellow
-    if (s == "vaccinated") return sf::Color(152, 251, 152); // green
-    return sf::Color(240, 240, 240);                        //  gray 
-}
+    bool _recording = false; /* <Whether state changes are appended to _transitions*/
+    std::vector<CellTransition> _transitions; /* <State changes since the last clearTransitions()*/
 
+    /**
+     * @brief Bookkeeping for a mutator about to set cell (i, j) to state to: restarts its age and records the change.
+     */
+    void setCode(int i, int j, CellState to) {
+        const std::size_t idx = static_cast<std::size_t>(i) * _n + j;
+        if (!_age.empty()) _age[idx] = 0;
+        if (_recording) noteTransition(idx, stateCode(i, j), to);
+    }
 
-public:
     /**
-    * @brief Aggregate counts of each epidemiological state in the grid.
-    */
-    struct Counts {
-    int susceptible = 0;
-    int infected = 0;
-    int recovered = 0;
-    int vaccinated = 0;
-    };
+     * @brief Appends a state change of cell idx to the transition list, if recording.
+     */
+    void noteTransition(std::size_t idx, CellState from, CellState to) {
+        if (_recording && from != to) _transitions.push_back({static_cast<std::int32_t>(idx), from, to});
+    }
+
+    CellState stateCode(int i, int j) const { return cellStateFromString(_m[i][j].getState()); }
+
+    /**
+     * @brief Calls f with std::true_type or std::false_type, so a runtime flag can pick a template specialization.
+     */
+    template <typename F>
+    static void withFlag(bool flag, F&& f) {
+        if (flag) f(std::true_type{});
+        else      f(std::false_type{});
+    }
+
+    /**
+     * @brief Vaccination rate of cell idx under the heterogeneous model.
+     */
+    float vaccinationRate(std::size_t idx) const { return _rv * (1.0f - _hesitancy[idx]); }
+
+    /**
+     * @brief Makes sure all three rate planes exist, filling missing ones with the homogeneous values.
+     */
+    void ensureRatePlanes() {
+        const std::size_t cells = static_cast<std::size_t>(_n) * _n;
+        if (_susceptibility.empty()) _susceptibility.fill(cells, 1.0f);
+        if (_recovery.empty())       _recovery.fill(cells, 1.0f);
+        if (_hesitancy.empty())      _hesitancy.fill(cells, 0.0f);
+    }
 
+    /**
+     * @brief Rejects a per-cell plane that is not one value in [0, maxValue] per cell, before
+     *        anything is changed.
+     */
+    void checkPlane(const std::vector<float>& values, const char* what,
+                    float maxValue = std::numeric_limits<float>::infinity()) const {
+        if (values.size() != static_cast<std::size_t>(_n) * _n) {
+            throw std::invalid_argument(std::string("Population::") + what + ": expected one value per cell");
+        }
+        for (float v : values) {
+            if (!(v >= 0.0f && v <= maxValue)) {
+                throw std::invalid_argument(std::string("Population::") + what + ": value out of range");
+            }
+        }
+    }
+
+    /**
+     * @brief Copies the grid's state codes into _halo and fills the halo ring per the boundary condition.
+     *
+     * After this the stencil can read any neighbor within the neighborhood radius without a
+     * bounds check: Closed fills the ring with a code that is never infected, Periodic and
+     * Reflecting copy the cell the ring position maps to.
+     * @return Counts of the grid, gathered in the same pass.
+     */
+    Counts fillHalo() {
+        EPIDEMIC_PHASE("Population::Update/halo");
+        const int h = _haloWidth = _neighborhood.isVonNeumann() ? 1 : _neighborhood.radius();
+        const int w = _n + 2 * h;
+        const std::uint8_t outside = 0xFF;
+        _halo.assign(static_cast<std::size_t>(w) * w, outside);
+        Counts c;
+        int counts[4] = {0, 0, 0, 0};
+        for (int i = 0; i < _n; ++i) {
+            std::uint8_t* row = &_halo[static_cast<std::size_t>(i + h) * w + h];
+            for (int j = 0; j < _n; ++j) {
+                std::uint8_t code = static_cast<std::uint8_t>(cellStateFromString(_m[i][j].getState()));
+                row[j] = code;
+                ++counts[code];
+            }
+        }
+        c.susceptible = counts[0];
+        c.infected    = counts[1];
+        c.recovered   = counts[2];
+        c.vaccinated  = counts[3];
+        if (_boundary == Boundary::Closed) return c;
+
+        for (int i = -h; i < _n + h; ++i) {
+            const int si = (i < 0 || i >= _n) ? boundaryIndex(i, _n, _boundary) : i;
+            std::uint8_t* row = &_halo[static_cast<std::size_t>(i + h) * w + h];
+            const std::uint8_t* src = &_halo[static_cast<std::size_t>(si + h) * w + h];
+            for (int j = -h; j < _n + h; ++j) {
+                if (i >= 0 && i < _n && j >= 0 && j < _n) {
+                    j = _n - 1; //interior row: skip to the right-hand ring
+                    continue;
+                }
+                row[j] = src[boundaryIndex(j, _n, _boundary)];
+            }
+        }
+        return c;
+    }
+
+    /**
+     * @brief One day of Update() for the susceptible and infected Person at (i, j).
+     *
+     * Neighbors are read from the halo plane, so there are no bounds checks, and all flags
+     * are compile-time so that each specialization's loop carries no invariant branches:
+     * SusVaccine says whether susceptible Persons may be vaccinated today, Custom switches
+     * from the four-neighbor count to the summed-area-table neighborhood, Hetero scales the
+     * rates by the per-cell rate planes and Aged takes the recovery probability from the
+     * infectious-period table and advances the cell's age in the same pass.
+     * Cells whose only possible events are rare go to the candidate lists instead, and infected
+     * cells are listed in infected when it is not null (for the mobility layer).
+     */
+    template <bool SusVaccine, bool Custom, bool Hetero, bool Aged>
+    void updateCell(int i, int j, std::uniform_real_distribution<>& dis,
+                    std::vector<int>& quietSusceptible, std::vector<int>& recovered,
+                    std::vector<int>* infected) {
+        constexpr std::uint8_t S = static_cast<std::uint8_t>(CellState::Susceptible);
+        constexpr std::uint8_t I = static_cast<std::uint8_t>(CellState::Infected);
+        constexpr std::uint8_t R = static_cast<std::uint8_t>(CellState::Recovered);
+        const std::ptrdiff_t w = _n + 2 * _haloWidth;
+        const std::uint8_t* cell = &_halo[static_cast<std::size_t>(i + _haloWidth) * w + (j + _haloWidth)];
+        const std::size_t idx = static_cast<std::size_t>(i) * _n + j;
+        bool changed = false;
+        if (*cell == S){ //update for susceptible Persons
+            float sum = 0;
+            if (Custom){
+                sum = _sums.pressure(i + _haloWidth, j + _haloWidth, _neighborhood); //weighted number of infected cells in the neighborhood
+            } else {
+                //finding number of infected neighbors
+                sum = (cell[-w] == I) + (cell[w] == I) + (cell[-1] == I) + (cell[1] == I);
+            }
+            if (sum <= 0){ //only vaccination can happen, which is rare
+                if (SusVaccine){
+                    quietSusceptible.push_back(i*_n + j);
+                }
+            } else {
+                float seed = dis(_gen); //the seed to determine which event happens for this person
+                float chance_inf = sum*_ri; //chance of infection = number of infected neighbors * infection rate
+                if (Hetero) chance_inf *= _susceptibility[idx];
+                if (seed < chance_inf){
+                    _m[i][j].set_inf();
+                    noteTransition(idx, CellState::Susceptible, CellState::Infected);
+                    changed = true;
+                } else if (SusVaccine){ //If the vaccine has been discovered
+                    float rv = Hetero ? vaccinationRate(idx) : _rv;
+                    if (chance_inf < seed && seed < chance_inf + rv){ //With a vaccine rate % chance, set the Person to vaccinated
+                        _m[i][j].set_vac();
+                        noteTransition(idx, CellState::Susceptible, CellState::Vaccinated);
+                        changed = true;
+                    }
+                }
+            }
+        } else if (*cell == I) { //update for infected Persons
+            if (infected) infected->push_back(i*_n + j);
+            float seed = dis(_gen);
+            float rr = Aged ? _period.hazard(_age[idx]) : _rr; //recovery chance after this many days infected
+            if (Hetero) rr *= _recovery[idx];
+            if (seed < rr){ //with a recovery rate % chance, set the Person to recovered
+                _m[i][j].set_rec();
+                noteTransition(idx, CellState::Infected, CellState::Recovered);
+                changed = true;
+            }
+        } else if (*cell == R) { //mutation and vaccination are both rare
+            recovered.push_back(i*_n + j);
+        }
+        if (Aged){
+            //one more day in the same state (saturating at 255), or day 0 of a new one
+            const std::uint8_t age = _age[idx];
+            _age[idx] = static_cast<std::uint8_t>((age + (age != 255)) * !changed);
+        }
+    }
+
+    /**
+     * @brief Walks the grid tile by tile (a single tile, i.e. row-major, unless tiling is enabled).
+     */
+    template <bool SusVaccine, bool Custom, bool Hetero, bool Aged>
+    void sweep(std::uniform_real_distribution<>& dis,
+               std::vector<int>& quietSusceptible, std::vector<int>& recovered,
+               std::vector<int>* infected) {
+        for (const Tile& tile : makeTiles(_n, tileSize())){
+            for (int i = tile.i0; i < tile.i1; i++){
+                for (int j = tile.j0; j < tile.j1; j++){
+                    updateCell<SusVaccine, Custom, Hetero, Aged>(i, j, dis, quietSusceptible, recovered, infected);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Snapshot of the grid as one CellState byte per cell, row-major.
+     */
+    std::vector<std::uint8_t> loadCodes() const {
+        std::vector<std::uint8_t> codes(static_cast<std::size_t>(_n) * _n);
+        for (int i = 0; i < _n; ++i) {
+            for (int j = 0; j < _n; ++j) {
+                codes[static_cast<std::size_t>(i) * _n + j] =
+                    static_cast<std::uint8_t>(cellStateFromString(_m[i][j].getState()));
+            }
+        }
+        return codes;
+    }
+
+    /**
+     * @brief Writes byte codes back into the grid, touching only cells that changed.
+     * @param before Codes the grid currently holds (as returned by loadCodes()).
+     * @param after Codes to store.
+     */
+    void storeCodes(const std::vector<std::uint8_t>& before, const std::vector<std::uint8_t>& after) {
+        for (std::size_t idx = 0; idx < after.size(); ++idx) {
+            if (before[idx] == after[idx]) continue;
+            noteTransition(idx, static_cast<CellState>(before[idx]), static_cast<CellState>(after[idx]));
+            Person& p = _m[idx / _n][idx % _n];
+            switch (static_cast<CellState>(after[idx])) {
+                case CellState::Susceptible: p.set_sus(); break;
+                case CellState::Infected:    p.set_inf(); break;
+                case CellState::Recovered:   p.set_rec(); break;
+                case CellState::Vaccinated:  p.set_vac(); break;
+            }
+        }
+    }
+
+
+public:
     /**
      * @brief Parameterized constructor initializes a matrix m of size n*n which holds elements of type T. All elements are initially set to susceptible people
      * @param n size of matrix
      */    
     explicit Population(int n)
-    : _m(n, std::vector<Person>(n)), _n(n) {}
+    : Population(n, std::random_device{}()) {}
+
+    /**
+     * @brief Same as Population(int) but with a fixed seed, so runs are reproducible.
+     * @param n size of matrix
+     * @param seed seed for every random draw the Population makes
+     */
+    Population(int n, std::uint64_t seed)
+    : _m(n, std::vector<Person>(n)), _n(n), _seed(seed), _gen(seed) {}
 
     // Accessors
     Person getPerson(int i, int j) const { return _m[i][j]; }
@@ -64,16 +316,173 @@ public:
     int size() const { return _n; }
 
     // Mutators
-    void set_sus(int i, int j) { _m[i][j].set_sus(); }
-    void set_inf(int i, int j) { _m[i][j].set_inf(); }
-    void set_rec(int i, int j) { _m[i][j].set_rec(); }
-    void set_vac(int i, int j) { _m[i][j].set_vac(); }
+    void set_sus(int i, int j) { setCode(i, j, CellState::Susceptible); _m[i][j].set_sus(); }
+    void set_inf(int i, int j) { setCode(i, j, CellState::Infected); _m[i][j].set_inf(); }
+    void set_rec(int i, int j) { setCode(i, j, CellState::Recovered); _m[i][j].set_rec(); }
+    void set_vac(int i, int j) { setCode(i, j, CellState::Vaccinated); _m[i][j].set_vac(); }
+
+    /**
+     * @brief Sets the traversal tile used by Update().
+     * @param tile Side length of square tiles in cells; 0 restores row-major traversal.
+     */
+    void setTileSize(int tile) { _tile = tile; _autoTile = false; }
+
+    /**
+     * @brief Sizes Update()'s tiles from the detected L2 cache so that the data the sweep
+     *        touches for a tile stays cached.
+     *
+     * The size follows sweepBytesPerCell(), so it adapts when rate planes or the age plane
+     * are switched on later.
+     */
+    void useAutoTileSize() { _autoTile = true; }
+
+    /**
+     * @brief Bytes Update()'s sweep streams per cell: the cell's halo code, the Person it writes
+     *        back on a transition, and the per-cell planes that are in use.
+     */
+    std::size_t sweepBytesPerCell() const {
+        std::size_t bytes = 1 + sizeof(Person);
+        if (heterogeneous()) bytes += 3 * sizeof(RateCode); //susceptibility, recovery, hesitancy
+        if (tracksAge()) bytes += 1;
+        if (!_neighborhood.isVonNeumann()) bytes += sizeof(std::int32_t); //summed-area table
+        return bytes;
+    }
+
+    int tileSize() const { return _autoTile ? autoTileSize(sweepBytesPerCell()) : _tile; }
+
+    /**
+     * @brief Sets which cells can infect a susceptible cell (von Neumann by default).
+     * @param nb Neighborhood; box neighborhoods are evaluated from a summed-area table,
+     *        at a cost per cell that does not depend on their radius.
+     */
+    void setNeighborhood(const Neighborhood& nb) { _neighborhood = nb; }
+    const Neighborhood& neighborhood() const { return _neighborhood; }
+
+    /**
+     * @brief Sets the boundary condition: closed (the default, as in the original model),
+     *        periodic (toroidal) or reflecting.
+     */
+    void setBoundary(Boundary b) { _boundary = b; }
+    Boundary boundary() const { return _boundary; }
+
+    /**
+     * @brief Sets a per-cell multiplier of the infection rate, e.g. from an age map.
+     *
+     * The first per-cell plane switches the Population to the heterogeneous model; planes not
+     * set explicitly keep the homogeneous value (multiplier 1, no hesitancy).
+     * @param s Row-major n*n non-negative multipliers, quantized to RateCode over [0, max(s)].
+     * @throws std::invalid_argument If s has the wrong size or a negative or NaN entry.
+     */
+    void setSusceptibility(const std::vector<float>& s) {
+        checkPlane(s, "setSusceptibility");
+        ensureRatePlanes();
+        _susceptibility.assign(s);
+    }
+
+    /**
+     * @brief Sets a per-cell multiplier of the recovery rate.
+     * @param r Row-major n*n non-negative multipliers, quantized to RateCode over [0, max(r)].
+     * @throws std::invalid_argument If r has the wrong size or a negative or NaN entry.
+     */
+    void setRecoverySpeed(const std::vector<float>& r) {
+        checkPlane(r, "setRecoverySpeed");
+        ensureRatePlanes();
+        _recovery.assign(r);
+    }
+
+    /**
+     * @brief Sets the per-cell probability that a vaccination event is turned down.
+     *
+     * This is individual hesitancy and scales the cell's vaccination rate by (1 - h); the
+     * population-wide cap set by the hesitancy rate still applies on top.
+     * @param h Row-major n*n values in [0, 1].
+     * @throws std::invalid_argument If h has the wrong size or an entry outside [0, 1].
+     */
+    void setHesitancy(const std::vector<float>& h) {
+        checkPlane(h, "setHesitancy", 1.0f);
+        ensureRatePlanes();
+        _hesitancy.assign(h, 1.0f);
+    }
+
+    /**
+     * @brief Drops the per-cell rate planes, returning to the homogeneous model.
+     */
+    void clearRatePlanes() {
+        _susceptibility.clear();
+        _recovery.clear();
+        _hesitancy.clear();
+    }
+
+    bool heterogeneous() const { return !_susceptibility.empty(); }
+
+    /**
+     * @brief Adds long-range contacts from infected cells (MobilityLayer::none() removes them).
+     */
+    void setMobility(const MobilityLayer& m) { _mobility = m; }
+    const MobilityLayer& mobility() const { return _mobility; }
+
+    /**
+     * @brief Replaces the daily recovery chance rr with a distribution of the infectious period.
+     *
+     * This turns on the per-cell age plane (one byte per cell counting days in the current
+     * state, saturating at 255), which Update() advances in the same pass as the transitions.
+     * Every cell starts at age 0. InfectiousPeriod::geometric(rr) reproduces the original model.
+     */
+    void setInfectiousPeriod(const InfectiousPeriod& period) {
+        _period = period;
+        if (_age.empty()) _age.assign(static_cast<std::size_t>(_n) * _n, 0);
+    }
+
+    /**
+     * @brief Returns to the memoryless recovery rule and drops the age plane.
+     */
+    void clearInfectiousPeriod() {
+        _age.clear();
+        _age.shrink_to_fit();
+    }
+
+    bool tracksAge() const { return !_age.empty(); }
+
+    /**
+     * @brief Starts or stops recording every state change in transitions().
+     *
+     * While recording, Update(), advance() and the set_* mutators append one CellTransition
+     * per cell that changes, so a consumer (such as a display pyramid) can follow the grid in
+     * time proportional to the number of changes. The list grows until clearTransitions().
+     */
+    void recordTransitions(bool on) {
+        _recording = on;
+        if (!on) clearTransitions();
+    }
+
+    bool recordsTransitions() const { return _recording; }
+
+    /**
+     * @brief State changes since recording started or the last clearTransitions(), in order.
+     */
+    const std::vector<CellTransition>& transitions() const { return _transitions; }
+
+    void clearTransitions() { _transitions.clear(); }
+
+    /**
+     * @brief Snapshot of the grid as one CellState byte per cell, row-major.
+     */
+    std::vector<std::uint8_t> stateCodes() const { return loadCodes(); }
+
+    /**
+     * @brief Days cell (i, j) has spent in its current state (0 on the day it entered it, at most 255); 0 when not tracked.
+     */
+    int daysInState(int i, int j) const { return _age.empty() ? 0 : _age[static_cast<std::size_t>(i) * _n + j]; }
+    int day() const { return _t; }
+    SirvRates rates() const { return SirvRates{_ri, _rr, _rm, _rv, _rvh, _tv}; }
+    std::uint64_t seed() const { return _seed; }
 
     /**
      * @brief Counts the number of Persons with each state
      * @return Counts 
      */
     Counts countStates() const {
+        EPIDEMIC_PHASE("Population::countStates");
         Counts c;
         for (int i = 0; i < _n; ++i) {
             for (int j = 0; j < _n; ++j) {
@@ -91,87 +500,224 @@ public:
      * @brief Updates the state of the population according to our Markov Chain model
      */
     void Update() {
+        EPIDEMIC_PHASE("Population::Update");
         ++_t;
-        Counts c = countStates();
+        Counts c = fillHalo(); //start-of-step snapshot; transitions below read it and write _m
         int total = _n * _n;
         float fracVaccinated =
             static_cast<float>(c.vaccinated) / static_cast<float>(total);
         bool allowVaccination = (fracVaccinated < (1.0f - _rvh));
 
-        
-        auto mOld = _m;
-
-        std::random_device rd;  // Seed for random number 
-        std::mt19937 gen(rd()); // Standard mersenne_twister_engine seeded with rd()
+        auto& gen = _gen;
         std::uniform_real_distribution<> dis(0.0, 1.0); //generating U(0,1) for future probabilities
 
-        for (int i = 0; i < _n; i++){
-            for (int j = 0; j < _n; j++){
-                float seed = dis(gen); //the seed to determine which event happens for this person
-                if (mOld[i][j].getState() == "susceptible"){ //update for susceptible Persons
-                    //finding number of infected neighbors
-                    int sum = 0;
-                    if (i-1 >= 0 && mOld[i-1][j].getState() == "infected"){
-                        sum += 1;
-                    }
-                    if (j-1 >= 0 && mOld[i][j-1].getState() == "infected"){
-                        sum += 1;
-                    }
-                    if (i+1 < _n && mOld[i+1][j].getState() == "infected"){
-                        sum += 1;
-                    }
-                    if (j+1 < _n && mOld[i][j+1].getState() == "infected"){
-                        sum += 1;
-                    }
-                    float chance_inf = sum*_ri; //chance of infection = number of infected neighbors * infection rate
-                    if (seed < chance_inf){
-                        _m[i][j].set_inf();
-                    } else if (_t >= _tv && allowVaccination){ //If the vaccine has been discovered
-                        if (chance_inf < seed && seed < chance_inf + _rv){ //With a vaccine rate % chance, set the Person to vaccinated
-                            _m[i][j].set_vac();
-                        }
-                    }
-                }
-                if (mOld[i][j].getState() == "infected") { //update for infected Persons
-                    if (seed < _rr){ //with a recovery rate % chance, set the Person to recovered
-                        _m[i][j].set_rec();
-                    }
-                }
-                if (mOld[i][j].getState() == "recovered") { //update for recovered Persons
-                    if (seed < _rm){ //with a mutation rate % chance, set the Person to susceptible
-                        _m[i][j].set_sus();
-                    } else if (_t > _tv && allowVaccination){ //if the vaccine has been discovered
-                        if (_rm < seed && seed < _rm + _rv){ //with a vaccine rate % chance, set the Person to vaccinated
-                            _m[i][j].set_vac();
-                    }
-                }
+        bool susVaccine = _t >= _tv && allowVaccination; //vaccination open to susceptible Persons today
+        bool recVaccine = _t > _tv && allowVaccination;  //vaccination open to recovered Persons today
+
+        // Cells whose only possible transitions are rare are not given a uniform each; they are
+        // collected here and skip-sampled below with GeometricSkipSampler.
+        std::vector<int> quietSusceptible; // susceptible Persons with no infected neighbors
+        std::vector<int> recovered;
+        std::vector<int> infected; // infected Persons, listed only for the mobility layer
+        const bool mobility = _mobility.enabled();
+        const bool aged = tracksAge();
+
+        {
+            EPIDEMIC_PHASE("Population::Update/sweep");
+            const bool custom = !_neighborhood.isVonNeumann();
+            const bool hetero = heterogeneous();
+            if (custom){
+                _sums.build(_halo, _n + 2 * _haloWidth);
             }
+            //pick the kernel once per step; the per-cell code then has no vaccine, neighborhood, rate-plane or age checks
+            withFlag(susVaccine, [&](auto sus){
+                withFlag(custom, [&](auto cst){
+                    withFlag(hetero, [&](auto het){
+                        withFlag(aged, [&](auto agd){
+                            sweep<decltype(sus)::value, decltype(cst)::value, decltype(het)::value, decltype(agd)::value>(
+                                dis, quietSusceptible, recovered, mobility ? &infected : nullptr);
+                        });
+                    });
+                });
+            });
+        }
+
+        {
+            EPIDEMIC_PHASE("Population::Update/rare");
+            //with rate planes the per-cell vaccination rates differ, so candidates are skip-sampled
+            //at the largest rate and each hit is kept with probability rate / largest (thinning)
+            const bool hetero = heterogeneous();
+            const float rvMax = hetero ? _rv * (1.0f - _hesitancy.minValue()) : _rv;
+
+            //quiet susceptible Persons become vaccinated with a vaccine rate % chance
+            GeometricSkipSampler(rvMax).forEachHit(quietSusceptible.size(), gen, [&](std::size_t k){
+                int idx = quietSusceptible[k];
+                if (hetero && dis(gen) * rvMax >= vaccinationRate(idx)) return;
+                _m[idx / _n][idx % _n].set_vac();
+                noteTransition(idx, CellState::Susceptible, CellState::Vaccinated);
+                if (aged) _age[idx] = 0;
+            });
+
+            //recovered Persons either mutate (back to susceptible) or get vaccinated; draw whether either
+            //happens first, then split the hit between the two with their relative rates
+            float recEvent = _rm + (recVaccine ? rvMax : 0.0f);
+            GeometricSkipSampler(recEvent).forEachHit(recovered.size(), gen, [&](std::size_t k){
+                int idx = recovered[k];
+                double u = dis(gen) * recEvent;
+                if (u < _rm){
+                    _m[idx / _n][idx % _n].set_sus();
+                    noteTransition(idx, CellState::Recovered, CellState::Susceptible);
+                    if (aged) _age[idx] = 0;
+                } else if (!hetero || u < _rm + vaccinationRate(idx)){
+                    _m[idx / _n][idx % _n].set_vac();
+                    noteTransition(idx, CellState::Recovered, CellState::Vaccinated);
+                    if (aged) _age[idx] = 0;
+                }
+            });
         }
-        }   
 
+        if (mobility){
+            EPIDEMIC_PHASE("Population::Update/mobility");
+            //a remote infection of a cell that was susceptible at the start of the day takes
+            //precedence over whatever the local rules did to it today; with per-cell
+            //susceptibility, contacts are drawn at the largest value and thinned to the target's
+            constexpr std::uint8_t S = static_cast<std::uint8_t>(CellState::Susceptible);
+            const int h = _haloWidth;
+            const std::size_t w = static_cast<std::size_t>(_n + 2 * h);
+            const bool hetero = heterogeneous();
+            const float maxSusceptibility = hetero ? _susceptibility.maxValue() : 1.0f;
+            _mobility.forEachContact(infected, _n, _boundary, gen, [&](int idx){
+                const int i = idx / _n, j = idx % _n;
+                if (hetero && dis(gen) * maxSusceptibility >= _susceptibility[idx]) return;
+                if (_halo[(i + h) * w + (j + h)] == S){
+                    if (_recording) noteTransition(idx, stateCode(i, j), CellState::Infected);
+                    _m[i][j].set_inf();
+                    if (aged) _age[idx] = 0;
+                }
+            }, maxSusceptibility);
+        }
     }
 
     /**
-     * @brief Render the grid to an SFML window using state-dependent colors.
-     * @param window RenderWindow to draw into.
-     * @param cellSize Side length of each square cell in pixels.
-     * @param gap Spacing between adjacent cells in pixels.
+     * @brief Advances the model k days with temporal blocking.
+     *
+     * Each tile is loaded once together with a k-cell ghost ring into a small byte buffer and
+     * stepped k times there, the valid region shrinking by one cell per day, before the core
+     * is written back. The grid therefore crosses main memory once per k days instead of once
+     * per day.
+     *
+     * The per-cell transition rules are those of Update(), but each cell draws its uniform from
+     * counterUniform(seed, day, cell), so the result does not depend on the tile size or on how
+     * the k days are split between calls. It is a different random stream from Update().
+     *
+     * The vaccination cap (allowVaccination) needs the global vaccinated count, which is not
+     * known inside a tile; it is evaluated once from the state at the start of the block and
+     * held for all k days. For k = 1 this is exactly Update()'s rule; for larger k the cap can
+     * be overshot by at most k days' worth of vaccinations.
+     *
+     * With a periodic or reflecting boundary, ghost cells past the grid edge are loaded from
+     * their image cell and draw the image cell's uniform, so they evolve exactly like the cell
+     * they stand for and the tile is stepped over its whole extended region.
+     *
+     * The tile kernel implements the homogeneous von Neumann model only; with any other
+     * neighborhood (whose ghost ring would be k times its radius), with per-cell rate planes,
+     * with a mobility layer (whose contacts cross tiles) or with an infectious-period
+     * distribution this simply calls Update() k times.
+     * @param k Number of days to advance; values <= 0 do nothing.
      */
-    void draw(sf::RenderWindow& window,
-              float cellSize = 25.f,
-              float gap = 1.f) const {
-        window.clear(sf::Color(40, 40, 40)); // dark background
+    void advance(int k) {
+        if (k <= 0) return;
+        if (!_neighborhood.isVonNeumann() || heterogeneous() || _mobility.enabled() || tracksAge()){
+            for (int s = 0; s < k; s++) Update();
+            return;
+        }
+        EPIDEMIC_PHASE("Population::advance");
+        Counts c = countStates();
+        float fracVaccinated =
+            static_cast<float>(c.vaccinated) / static_cast<float>(_n * _n);
+        bool allowVaccination = (fracVaccinated < (1.0f - _rvh));
 
-        sf::RectangleShape cell({cellSize, cellSize});
-        for (int i = 0; i < _n; ++i) {
-            for (int j = 0; j < _n; ++j) {
-                float x = gap + j * (cellSize + gap);
-                float y = gap + i * (cellSize + gap);
-                cell.setPosition({x, y});
-                cell.setFillColor(colorForState(_m[i][j].getState()));
-                window.draw(cell);
+        const std::vector<std::uint8_t> start = loadCodes();
+        std::vector<std::uint8_t> result(start.size());
+
+        const int tile = _tile > 0 ? _tile : autoTileSize(2);
+        const std::uint8_t outside = 0xFF; // ghost cells beyond the grid edge: never infected
+        const int t0 = _t;
+        const SirvRates rates = this->rates();
+
+        const bool closed = _boundary == Boundary::Closed;
+        //grid index of the cell a row/column of the extended region stands for
+        auto image = [&](int k) { return (k < 0 || k >= _n) ? boundaryIndex(k, _n, _boundary) : k; };
+
+        std::vector<std::uint8_t> a, b;
+        std::vector<int> rowOf, colOf;
+        for (const Tile& tl : makeTiles(_n, tile)){
+            //extended region [ei0, ei1) x [ej0, ej1) = tile plus k ghost cells on every side
+            const int ei0 = tl.i0 - k, ei1 = tl.i1 + k;
+            const int ej0 = tl.j0 - k, ej1 = tl.j1 + k;
+            const int w = ej1 - ej0;
+            a.assign(static_cast<std::size_t>(ei1 - ei0) * w, outside);
+            b = a;
+            rowOf.resize(ei1 - ei0);
+            colOf.resize(w);
+            for (int i = ei0; i < ei1; i++) rowOf[i - ei0] = closed ? i : image(i);
+            for (int j = ej0; j < ej1; j++) colOf[j - ej0] = closed ? j : image(j);
+            if (closed){
+                for (int i = std::max(ei0, 0); i < std::min(ei1, _n); i++){
+                    int j0 = std::max(ej0, 0), j1 = std::min(ej1, _n);
+                    std::copy(start.begin() + (static_cast<std::size_t>(i) * _n + j0),
+                              start.begin() + (static_cast<std::size_t>(i) * _n + j1),
+                              a.begin() + (static_cast<std::size_t>(i - ei0) * w + (j0 - ej0)));
+                }
+            } else {
+                for (int i = ei0; i < ei1; i++){
+                    const std::uint8_t* src = start.data() + static_cast<std::size_t>(rowOf[i - ei0]) * _n;
+                    std::uint8_t* dst = a.data() + static_cast<std::size_t>(i - ei0) * w;
+                    for (int x = 0; x < w; x++) dst[x] = src[colOf[x]];
+                }
+            }
+
+            for (int s = 1; s <= k; s++){
+                const int day = t0 + s;
+                const std::uint64_t key = dayKey(_seed, static_cast<std::uint64_t>(day));
+                const bool susVaccine = day >= _tv && allowVaccination;
+                const bool recVaccine = day > _tv && allowVaccination;
+                //after s days only cells at least k - s away from the ghost border are still exact
+                int i0 = ei0 + s, i1 = ei1 - s, j0 = ej0 + s, j1 = ej1 - s;
+                if (closed){
+                    i0 = std::max(i0, 0); i1 = std::min(i1, _n);
+                    j0 = std::max(j0, 0); j1 = std::min(j1, _n);
+                }
+                withVaccineFlags(susVaccine, recVaccine, [&](auto sus, auto rec){
+                    //the byte stores to out may alias anything reached through the closure, so
+                    //the inner loop works on locals only
+                    const std::uint64_t dk = key;
+                    const SirvRates r = rates;
+                    const int* cols = colOf.data();
+                    const int x0 = j0 - ej0, x1 = j1 - ej0, width = w;
+                    for (int i = i0; i < i1; i++){
+                        const std::uint8_t* row = a.data() + static_cast<std::size_t>(i - ei0) * width;
+                        std::uint8_t* out = b.data() + static_cast<std::size_t>(i - ei0) * width;
+                        const std::uint64_t base = static_cast<std::uint64_t>(rowOf[i - ei0]) * _n;
+                        for (int x = x0; x < x1; x++){
+                            const float seed = counterUniform(dk, base + cols[x]);
+                            out[x] = sirvStep<decltype(sus)::value, decltype(rec)::value>(
+                                row[x], row[x - width], row[x + width], row[x - 1], row[x + 1], seed, r);
+                        }
+                    }
+                });
+                std::swap(a, b);
+            }
+
+            for (int i = tl.i0; i < tl.i1; i++){
+                std::copy(a.begin() + (static_cast<std::size_t>(i - ei0) * w + (tl.j0 - ej0)),
+                          a.begin() + (static_cast<std::size_t>(i - ei0) * w + (tl.j1 - ej0)),
+                          result.begin() + (static_cast<std::size_t>(i) * _n + tl.j0));
             }
         }
+
+        storeCodes(start, result);
+        _t += k;
     }
 };
 
@@ -0,0 +1,345 @@
+/**
+ * @file PopulationView.hpp
+ * @brief SFML rendering of a Population; the only part of the model that depends on SFML.
+ */
+
+#ifndef POPULATION_VIEW_HPP
+#define POPULATION_VIEW_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <SFML/Graphics.hpp>
+#include "CountHistory.hpp"
+#include "LodPyramid.hpp"
+#include "Population.hpp"
+#include "PhaseTimer.hpp"
+
+/**
+ * @brief Map a state string to a display color.
+ * @param s State string: "susceptible", "infected", "recovered", or "vaccinated".
+ * @return A  @c sf::Color for the given state; light gray if unknown.
+ */
+inline sf::Color colorForState(const std::string& s) {
+    // match the example’s pastel palette
+    if (s == "infected")   return sf::Color(255, 182, 193); //  pink
+    if (s == "recovered")  return sf::Color(173, 216, 230); //  blue
+    if (s == "susceptible") return sf::Color(255, 239, 186); //  yellow
+    if (s == "vaccinated") return sf::Color(152, 251, 152); // green
+    return sf::Color(240, 240, 240);                        //  gray 
+}
+
+/**
+ * @brief Render the grid to an SFML window (or any render target) using state-dependent colors.
+ * @param window RenderWindow or RenderTexture to draw into.
+ * @param pop Population to draw.
+ * @param cellSize Side length of each square cell in pixels.
+ * @param gap Spacing between adjacent cells in pixels.
+ */
+inline void drawPopulation(sf::RenderTarget& window,
+                           const Population& pop,
+                           float cellSize = 25.f,
+                           float gap = 1.f) {
+    EPIDEMIC_PHASE("drawPopulation");
+    window.clear(sf::Color(40, 40, 40)); // dark background
+
+    const int n = pop.size();
+    sf::RectangleShape cell({cellSize, cellSize});
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            float x = gap + j * (cellSize + gap);
+            float y = gap + i * (cellSize + gap);
+            cell.setPosition({x, y});
+            cell.setFillColor(colorForState(pop.getState(i, j)));
+            window.draw(cell);
+        }
+    }
+}
+
+/**
+ * @class GridViewer
+ * @brief Zoomable, pannable view of a grid of any size, drawn from a LodPyramid.
+ *
+ * The view is a fixed-size pixel buffer uploaded as one texture. When zoomed out, each pixel
+ * is the blend of the state colors of the block of cells under it, weighted by their counts
+ * at the matching pyramid level; when zoomed in, it is the color of the cell under it. The
+ * buffer is only recomputed when the camera moves or the pyramid changes, and then costs one
+ * lookup per pixel however large the grid is.
+ */
+class GridViewer {
+    unsigned _width, _height;
+    float _cellsPerPixel = 1.f; /** <Zoom: grid cells per screen pixel along each axis */
+    float _originX = 0.f;       /** <Grid column at the left edge of the view */
+    float _originY = 0.f;       /** <Grid row at the top edge of the view */
+    bool _dirty = true;
+    std::array<sf::Color, 4> _palette;
+    std::vector<std::uint8_t> _pixels; /** <RGBA */
+    std::vector<int> _column;          /** <Grid column under each pixel column, or -1 */
+    sf::Texture _texture;
+
+    void put(std::size_t p, sf::Color c) {
+        _pixels[4 * p] = c.r;
+        _pixels[4 * p + 1] = c.g;
+        _pixels[4 * p + 2] = c.b;
+        _pixels[4 * p + 3] = 255;
+    }
+
+    void redraw(const LodPyramid& pyramid) {
+        EPIDEMIC_PHASE("GridViewer::redraw");
+        const int n = pyramid.size();
+        const sf::Color background(40, 40, 40);
+        //pyramid level whose blocks are closest to (not larger than) one pixel
+        int level = _cellsPerPixel >= (1 << LodPyramid::kFirstLevel)
+                  ? static_cast<int>(std::floor(std::log2(_cellsPerPixel))) : 0;
+        level = std::min(level, pyramid.topLevel());
+
+        for (unsigned x = 0; x < _width; ++x) {
+            const float col = _originX + (x + 0.5f) * _cellsPerPixel;
+            _column[x] = (col >= 0.f && col < n) ? static_cast<int>(col) : -1;
+        }
+        for (unsigned y = 0; y < _height; ++y) {
+            const float rowf = _originY + (y + 0.5f) * _cellsPerPixel;
+            const std::size_t p0 = static_cast<std::size_t>(y) * _width;
+            if (rowf < 0.f || rowf >= n) {
+                for (unsigned x = 0; x < _width; ++x) put(p0 + x, background);
+                continue;
+            }
+            const int row = static_cast<int>(rowf);
+            for (unsigned x = 0; x < _width; ++x) {
+                const int col = _column[x];
+                if (col < 0) {
+                    put(p0 + x, background);
+                } else if (level == 0) {
+                    put(p0 + x, _palette[static_cast<int>(pyramid.state(row, col))]);
+                } else {
+                    const std::uint16_t* c = pyramid.counts(level, row >> level, col >> level);
+                    const unsigned total = c[0] + c[1] + c[2] + c[3];
+                    unsigned r = 0, g = 0, b = 0;
+                    for (int s = 0; s < 4; ++s) {
+                        r += c[s] * _palette[s].r;
+                        g += c[s] * _palette[s].g;
+                        b += c[s] * _palette[s].b;
+                    }
+                    put(p0 + x, sf::Color(static_cast<std::uint8_t>(r / total), static_cast<std::uint8_t>(g / total),
+                                          static_cast<std::uint8_t>(b / total)));
+                }
+            }
+        }
+        _texture.update(_pixels.data());
+        _dirty = false;
+    }
+
+public:
+    /**
+     * @brief Creates a view of the given size in pixels.
+     */
+    GridViewer(unsigned width, unsigned height)
+    : _width(width), _height(height), _pixels(static_cast<std::size_t>(width) * height * 4),
+      _column(width), _texture(sf::Vector2u{width, height}) {
+        for (int s = 0; s < 4; ++s) _palette[s] = colorForState(cellStateName(static_cast<CellState>(s)));
+    }
+
+    unsigned width() const { return _width; }
+    unsigned height() const { return _height; }
+    float cellsPerPixel() const { return _cellsPerPixel; }
+
+    /**
+     * @brief Zooms and centers so a whole n×n grid is visible.
+     */
+    void fit(int n) {
+        _cellsPerPixel = static_cast<float>(n) / static_cast<float>(std::min(_width, _height));
+        _originX = 0.5f * (n - _width * _cellsPerPixel);
+        _originY = 0.5f * (n - _height * _cellsPerPixel);
+        _dirty = true;
+    }
+
+    /**
+     * @brief Zooms by factor (> 1 zooms in) keeping the grid point under the given pixel fixed.
+     */
+    void zoomAt(float factor, sf::Vector2i pixel) {
+        const float cx = _originX + pixel.x * _cellsPerPixel;
+        const float cy = _originY + pixel.y * _cellsPerPixel;
+        //from 1/64 of a cell (a cell 64 pixels wide) to 4096 cells per pixel
+        _cellsPerPixel = std::clamp(_cellsPerPixel / factor, 1.f / 64.f, 4096.f);
+        _originX = cx - pixel.x * _cellsPerPixel;
+        _originY = cy - pixel.y * _cellsPerPixel;
+        _dirty = true;
+    }
+
+    /**
+     * @brief Moves the view by the given number of pixels.
+     */
+    void pan(float dx, float dy) {
+        _originX -= dx * _cellsPerPixel;
+        _originY -= dy * _cellsPerPixel;
+        _dirty = true;
+    }
+
+    /**
+     * @brief Marks the view for recomputation, e.g. after the pyramid has been updated.
+     */
+    void invalidate() { _dirty = true; }
+
+    /**
+     * @brief Draws the view at the top-left corner of the target, recomputing it first if needed.
+     */
+    void draw(sf::RenderTarget& target, const LodPyramid& pyramid) {
+        if (_dirty) redraw(pyramid);
+        target.draw(sf::Sprite(_texture));
+    }
+};
+
+/**
+ * @class EpidemicChart
+ * @brief Live S/I/R/V curves of a CountHistory, drawn as a single vertex array.
+ *
+ * Each plot column holds the range of each state's count over the steps it covers (a vertical
+ * segment from min to max) joined to the previous column, so spikes survive decimation and the
+ * vertex count is bounded by the chart width, not by the length of the run. The geometry is
+ * rebuilt by update(), once per step, and draw() is one draw call.
+ */
+class EpidemicChart {
+    sf::Vector2f _position, _size;
+    sf::VertexArray _vertices{sf::PrimitiveType::Lines};
+    std::vector<CountHistory::Column> _columns;
+    std::array<sf::Color, 4> _palette;
+
+    void line(sf::Vector2f a, sf::Vector2f b, sf::Color c) {
+        _vertices.append(sf::Vertex{a, c, {}});
+        _vertices.append(sf::Vertex{b, c, {}});
+    }
+
+public:
+    /**
+     * @param position Top-left corner of the plot area.
+     * @param size Width and height of the plot area in pixels.
+     */
+    EpidemicChart(sf::Vector2f position, sf::Vector2f size) : _position(position), _size(size) {
+        for (int s = 0; s < 4; ++s) _palette[s] = colorForState(cellStateName(static_cast<CellState>(s)));
+    }
+
+    /**
+     * @brief Rebuilds the curves from the history.
+     * @param history Counts of the most recent steps.
+     * @param population Number of cells, the top of the y axis.
+     */
+    void update(const CountHistory& history, std::int64_t population) {
+        EPIDEMIC_PHASE("EpidemicChart::update");
+        _vertices.clear();
+        const float left = _position.x, top = _position.y, w = _size.x, h = _size.y;
+        const sf::Color axis(120, 120, 120);
+        line({left, top}, {left, top + h}, axis);
+        line({left, top + h}, {left + w, top + h}, axis);
+
+        history.decimate(static_cast<std::size_t>(w), _columns);
+        if (_columns.empty() || population <= 0) return;
+        const float dx = _columns.size() > 1 ? w / static_cast<float>(_columns.size() - 1) : 0.f;
+        auto y = [&](std::int64_t count) { return top + h - h * static_cast<float>(count) / static_cast<float>(population); };
+        for (std::size_t c = 0; c < _columns.size(); ++c) {
+            const CountHistory::Column& col = _columns[c];
+            const float x = left + c * dx;
+            for (int s = 0; s < 4; ++s) {
+                if (c > 0) line({x - dx, y(_columns[c - 1].last[s])}, {x, y(col.first[s])}, _palette[s]);
+                if (col.max[s] != col.min[s]) line({x, y(col.min[s])}, {x, y(col.max[s])}, _palette[s]);
+            }
+        }
+    }
+
+    void draw(sf::RenderTarget& target) const { target.draw(_vertices); }
+};
+
+/**
+ * @class LegendPanel
+ * @brief The side-panel legend: state colors, counts, step number and a frames/steps per second readout.
+ *
+ * The color boxes are one vertex array built in the constructor, and the texts are created
+ * once; the update functions only call setString when the displayed value changes, so a frame
+ * that repeats the previous counts costs the draw calls and nothing else. Without a font
+ * (an empty family) only the boxes are drawn.
+ */
+class LegendPanel {
+    enum Line { Title, Susceptible, Infected, Recovered, Vaccinated, Step, Rates };
+
+    sf::VertexArray _boxes{sf::PrimitiveType::Triangles};
+    std::vector<sf::Text> _texts; /** <Indexed by Line; empty without a font */
+    std::array<std::int64_t, 4> _shownCounts{{-1, -1, -1, -1}};
+    int _shownStep = -1;
+    int _shownFps = -1;
+    int _shownStepRate = -1; /** <Steps per second in tenths */
+
+    static constexpr const char* kNames[4] = {"Susceptible", "Infected", "Recovered", "Vaccinated"};
+
+    void addText(const sf::Font& font, unsigned size, sf::Vector2f position, const std::string& s) {
+        sf::Text text(font, s, size);
+        text.setFillColor(sf::Color::White);
+        text.setPosition(position);
+        _texts.push_back(std::move(text));
+    }
+
+public:
+    /**
+     * @param font Font of the texts; must outlive the panel.
+     * @param position Top-left corner of the panel.
+     */
+    LegendPanel(const sf::Font& font, sf::Vector2f position) {
+        const float x = position.x;
+        float y = position.y;
+        const bool hasText = !font.getInfo().family.empty();
+        if (hasText) addText(font, 20, {x, y}, "Legend");
+        y += 40.f;
+        for (int s = 0; s < 4; ++s) {
+            const sf::Color c = colorForState(cellStateName(static_cast<CellState>(s)));
+            const sf::Vector2f a{x, y}, b{x + 20.f, y}, d{x, y + 20.f}, e{x + 20.f, y + 20.f};
+            for (sf::Vector2f p : {a, b, d, b, e, d}) _boxes.append(sf::Vertex{p, c, {}});
+            if (hasText) addText(font, 16, {x + 30.f, y - 3.f}, kNames[s]);
+            y += 35.f;
+        }
+        if (hasText) {
+            addText(font, 18, {x, y + 15.f}, "Step: 0");
+            addText(font, 14, {x, y + 45.f}, "");
+        }
+    }
+
+    /**
+     * @brief Shows new counts and step number; texts are only rebuilt for values that changed.
+     */
+    void setCounts(const Population::Counts& c, int step) {
+        if (_texts.empty()) return;
+        const std::array<std::int64_t, 4> counts{{c.susceptible, c.infected, c.recovered, c.vaccinated}};
+        for (int s = 0; s < 4; ++s) {
+            if (counts[s] == _shownCounts[s]) continue;
+            _shownCounts[s] = counts[s];
+            _texts[Susceptible + s].setString(std::string(kNames[s]) + " : " + std::to_string(counts[s]));
+        }
+        if (step != _shownStep) {
+            _shownStep = step;
+            _texts[Step].setString("Step: " + std::to_string(step));
+        }
+    }
+
+    /**
+     * @brief Shows the measured display and simulation rates.
+     */
+    void setRates(float framesPerSecond, float stepsPerSecond) {
+        if (_texts.empty()) return;
+        const int fps = static_cast<int>(framesPerSecond + 0.5f);
+        const int tenths = static_cast<int>(stepsPerSecond * 10.f + 0.5f);
+        if (fps == _shownFps && tenths == _shownStepRate) return;
+        _shownFps = fps;
+        _shownStepRate = tenths;
+        _texts[Rates].setString(std::to_string(fps) + " fps   " + std::to_string(tenths / 10) + "." +
+                                std::to_string(tenths % 10) + " steps/s");
+    }
+
+    void draw(sf::RenderTarget& target) const {
+        EPIDEMIC_PHASE("LegendPanel::draw");
+        target.draw(_boxes);
+        for (const sf::Text& t : _texts) target.draw(t);
+    }
+};
+
+#endif // POPULATION_VIEW_HPP
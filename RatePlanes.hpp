@@ -0,0 +1,96 @@
+/**
+ * @file RatePlanes.hpp
+ * @brief Per-cell rate factors stored as quantized structure-of-arrays planes.
+ */
+
+#ifndef RATE_PLANES_HPP
+#define RATE_PLANES_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @brief Storage type of one quantized per-cell value.
+ *
+ * 8 bits (0.4% steps of the plane's range) by default; define EPIDEMIC_WIDE_RATE_PLANES for
+ * 16-bit codes at twice the memory traffic.
+ */
+#ifdef EPIDEMIC_WIDE_RATE_PLANES
+using RateCode = std::uint16_t;
+#else
+using RateCode = std::uint8_t;
+#endif
+
+/**
+ * @class RatePlane
+ * @brief One non-negative value per cell, as a contiguous row-major array of RateCode.
+ *
+ * A value is code * scale, where the scale is fixed per plane, so reading a cell is one
+ * narrow load and one multiply and a sweep over the grid streams the plane linearly next to
+ * the state codes.
+ */
+class RatePlane {
+private:
+    std::vector<RateCode> _codes; /** <Quantized values, row-major */
+    float _scale = 0.0f;          /** <Value of code 1 */
+    RateCode _minCode = 0;        /** <Smallest code in the plane */
+    RateCode _maxCode = 0;        /** <Largest code in the plane */
+
+public:
+    static constexpr RateCode kMaxCode = std::numeric_limits<RateCode>::max();
+
+    /**
+     * @brief Quantizes values to codes with the given range.
+     * @param values Row-major values, each in [0, maxValue].
+     * @param maxValue Value of the largest code.
+     * @throws std::invalid_argument If a value lies outside [0, maxValue]; the plane is then unchanged.
+     */
+    void assign(const std::vector<float>& values, float maxValue) {
+        if (!(maxValue > 0.0f)) throw std::invalid_argument("RatePlane: the range must be positive");
+        for (float v : values) {
+            if (!(v >= 0.0f && v <= maxValue)) throw std::invalid_argument("RatePlane: value outside [0, maxValue]");
+        }
+        _scale = maxValue / kMaxCode;
+        _codes.resize(values.size());
+        _minCode = kMaxCode;
+        _maxCode = 0;
+        for (std::size_t k = 0; k < values.size(); ++k) {
+            float q = std::min(std::round(values[k] / _scale), static_cast<float>(kMaxCode));
+            _codes[k] = static_cast<RateCode>(q);
+            _minCode = std::min(_minCode, _codes[k]);
+            _maxCode = std::max(_maxCode, _codes[k]);
+        }
+    }
+
+    /**
+     * @brief Quantizes values to codes, using the largest value as the top of the range.
+     * @param values Row-major non-negative values.
+     */
+    void assign(const std::vector<float>& values) {
+        float top = 0.0f;
+        for (float v : values) top = std::max(top, v);
+        assign(values, top > 0.0f ? top : 1.0f);
+    }
+
+    /**
+     * @brief Sets every one of cells cells to the same value, exactly representable as the top code.
+     */
+    void fill(std::size_t cells, float value) {
+        assign(std::vector<float>(cells, value), value > 0.0f ? value : 1.0f);
+    }
+
+    void clear() { _codes.clear(); }
+    bool empty() const { return _codes.empty(); }
+    std::size_t size() const { return _codes.size(); }
+
+    float operator[](std::size_t k) const { return _codes[k] * _scale; }
+    float minValue() const { return _minCode * _scale; }
+    float maxValue() const { return _maxCode * _scale; }
+};
+
+#endif // RATE_PLANES_HPP
@@ -0,0 +1,164 @@
+/**
+ * @file SimulationWorker.hpp
+ * @brief Steps a Population on a background thread and hands each step's changes to the caller.
+ */
+
+#ifndef SIMULATION_WORKER_HPP
+#define SIMULATION_WORKER_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "CellState.hpp"
+#include "PhaseTimer.hpp"
+#include "Population.hpp"
+
+/**
+ * @class SimulationWorker
+ * @brief Runs Population::Update() off the caller's thread, as many steps as the caller allows.
+ *
+ * Each step becomes a Batch holding the day, the transitions the step made and the counts
+ * after it. The counts are carried forward from the previous batch by applying the
+ * transitions, so a step costs nothing beyond Update() itself in proportion to the grid.
+ * A caller that draws the grid therefore never waits for a step: it collects the finished
+ * batches with take() and applies them to whatever mirrors the grid. If more than maxQueued
+ * batches are waiting, the worker pauses until take() is called, which bounds their memory.
+ *
+ * The worker owns the Population from construction until destruction; the caller must not
+ * touch it in between.
+ */
+class SimulationWorker {
+public:
+    /**
+     * @brief Outcome of one step.
+     */
+    struct Batch {
+        int day = 0;                             /** <Day the step led to */
+        std::vector<CellTransition> transitions; /** <Changes made by the step, in order */
+        Population::Counts counts;               /** <Counts after the step */
+    };
+
+private:
+    Population& _pop;
+    int _maxSteps;
+    std::size_t _maxQueued;
+    std::deque<Batch> _queue;
+    std::mutex _mutex;
+    std::condition_variable _wake; /** <Signals the worker: steps allowed, queue drained or stopping */
+    int _allowed = 0;  /** <Steps the worker may have taken in total */
+    int _started = 0;  /** <Steps begun */
+    int _finished = 0; /** <Steps whose batch has been queued */
+    bool _stopping = false;
+    std::thread _thread;
+
+    static void applyCounts(Population::Counts& c, const std::vector<CellTransition>& transitions) {
+        int* field[4] = {&c.susceptible, &c.infected, &c.recovered, &c.vaccinated};
+        for (const CellTransition& t : transitions) {
+            --*field[static_cast<int>(t.from)];
+            ++*field[static_cast<int>(t.to)];
+        }
+    }
+
+    void run(Population::Counts counts) {
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wake.wait(lock, [&] {
+                    return _stopping || (_started < _allowed && _queue.size() < _maxQueued);
+                });
+                if (_stopping) return;
+                ++_started;
+            }
+
+            Batch batch;
+            {
+                EPIDEMIC_PHASE("main/update");
+                _pop.Update();
+            }
+            batch.day = _pop.day();
+            batch.transitions = _pop.transitions();
+            _pop.clearTransitions();
+            applyCounts(counts, batch.transitions);
+            batch.counts = counts;
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            _queue.push_back(std::move(batch));
+            ++_finished;
+        }
+    }
+
+public:
+    /**
+     * @brief Starts the worker thread; it takes no step until allowed to.
+     * @param pop Population to step; transition recording is switched on.
+     * @param maxSteps Steps after which the worker stops for good.
+     * @param maxQueued Batches that may wait for take() before the worker pauses.
+     */
+    SimulationWorker(Population& pop, int maxSteps, std::size_t maxQueued = 256)
+    : _pop(pop), _maxSteps(maxSteps), _maxQueued(std::max<std::size_t>(maxQueued, 1)) {
+        _pop.recordTransitions(true);
+        _pop.clearTransitions();
+        _thread = std::thread(&SimulationWorker::run, this, _pop.countStates());
+    }
+
+    SimulationWorker(const SimulationWorker&) = delete;
+    SimulationWorker& operator=(const SimulationWorker&) = delete;
+
+    /**
+     * @brief Stops the worker once its current step, if any, is done.
+     */
+    ~SimulationWorker() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _wake.notify_one();
+        _thread.join();
+    }
+
+    /**
+     * @brief Allows one more step, or every remaining step when all is true.
+     */
+    void allow(bool all = false) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _allowed = all ? _maxSteps : std::min(_allowed + 1, _maxSteps);
+        }
+        _wake.notify_one();
+    }
+
+    /**
+     * @brief Withdraws the steps allowed but not yet begun.
+     */
+    void pause() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _allowed = _started;
+    }
+
+    /**
+     * @brief Whether every allowed step has finished (its batch may still be waiting for take()).
+     */
+    bool idle() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _finished == _allowed;
+    }
+
+    /**
+     * @brief Moves the finished batches, oldest first, to the end of out.
+     */
+    void take(std::vector<Batch>& out) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (Batch& b : _queue) out.push_back(std::move(b));
+            _queue.clear();
+        }
+        _wake.notify_one();
+    }
+};
+
+#endif // SIMULATION_WORKER_HPP
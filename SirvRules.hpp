@@ -0,0 +1,104 @@
+/**
+ * @file SirvRules.hpp
+ * @brief Model rates and the per-cell S/I/R/V transition rule shared by the byte-plane kernels.
+ */
+
+#ifndef SIRV_RULES_HPP
+#define SIRV_RULES_HPP
+
+#include <cstdint>
+#include <type_traits>
+#include "CellState.hpp"
+
+/**
+ * @brief The model parameters, with the same defaults as Population.
+ */
+struct SirvRates {
+    float ri  = 0.20f;          /** <Infection rate per infected neighbor */
+    float rr  = 1.0f / 20.0f;   /** <Recovery rate */
+    float rm  = 1.0f / 200.0f;  /** <Mutation rate (recovered back to susceptible) */
+    float rv  = 1.0f / 1000.0f; /** <Vaccination rate */
+    float rvh = 0.2f;           /** <Vaccine hesitancy: vaccination stops once 1 - rvh of people are vaccinated */
+    int   tv  = 200;            /** <Day the vaccine becomes available */
+};
+
+/**
+ * @brief The global vaccination cap: whether the vaccinated fraction is still below 1 - rvh.
+ * @param vaccinated Number of vaccinated cells.
+ * @param total Number of cells.
+ * @param r Model rates.
+ */
+inline bool vaccinationAllowed(std::int64_t vaccinated, std::int64_t total, const SirvRates& r) {
+    float fracVaccinated = static_cast<float>(vaccinated) / static_cast<float>(total);
+    return fracVaccinated < (1.0f - r.rvh);
+}
+
+/**
+ * @brief One day of Population::Update()'s rules for a single cell given its number of infected neighbors.
+ *
+ * The vaccine flags are template parameters so a kernel instantiated for the day's flags has
+ * no invariant branches in its cell loop; use withVaccineFlags() to pick the instantiation
+ * once per day.
+ * @tparam SusVaccine Whether susceptible cells may be vaccinated today.
+ * @tparam RecVaccine Whether recovered cells may be vaccinated today.
+ * @param self Code of the cell.
+ * @param infected Number of infected neighbors (only read for susceptible cells).
+ * @param seed The cell's uniform for the day.
+ * @param r Model rates.
+ * @return The cell's code for the next day.
+ */
+template <bool SusVaccine, bool RecVaccine>
+inline std::uint8_t sirvStepCount(std::uint8_t self, int infected, float seed, const SirvRates& r) {
+    constexpr std::uint8_t S = static_cast<std::uint8_t>(CellState::Susceptible);
+    constexpr std::uint8_t I = static_cast<std::uint8_t>(CellState::Infected);
+    constexpr std::uint8_t R = static_cast<std::uint8_t>(CellState::Recovered);
+    constexpr std::uint8_t V = static_cast<std::uint8_t>(CellState::Vaccinated);
+    if (self == S){
+        float chance_inf = infected*r.ri;
+        if (seed < chance_inf) return I;
+        if (SusVaccine && chance_inf < seed && seed < chance_inf + r.rv) return V;
+    } else if (self == I){
+        if (seed < r.rr) return R;
+    } else if (self == R){
+        if (seed < r.rm) return S;
+        if (RecVaccine && r.rm < seed && seed < r.rm + r.rv) return V;
+    }
+    return self;
+}
+
+/**
+ * @brief sirvStepCount() for a grid cell with the four von Neumann neighbors.
+ * @param self Code of the cell; up, down, left, right are its neighbors (any non-CellState
+ *        value, e.g. 0xFF, stands for "outside the grid").
+ * @param seed The cell's uniform for the day.
+ * @param r Model rates.
+ * @return The cell's code for the next day.
+ */
+template <bool SusVaccine, bool RecVaccine>
+inline std::uint8_t sirvStep(std::uint8_t self, std::uint8_t up, std::uint8_t down,
+                             std::uint8_t left, std::uint8_t right,
+                             float seed, const SirvRates& r) {
+    constexpr std::uint8_t I = static_cast<std::uint8_t>(CellState::Infected);
+    int sum = (up == I) + (down == I) + (left == I) + (right == I);
+    return sirvStepCount<SusVaccine, RecVaccine>(self, sum, seed, r);
+}
+
+/**
+ * @brief Calls f(std::integral_constant<bool, sus>, std::integral_constant<bool, rec>), turning
+ *        the day's run-time vaccine flags into compile-time ones for sirvStep.
+ * @param susVaccine Whether susceptible cells may be vaccinated today.
+ * @param recVaccine Whether recovered cells may be vaccinated today.
+ * @param f Generic callable, typically a lambda taking (auto sus, auto rec).
+ */
+template <class F>
+inline void withVaccineFlags(bool susVaccine, bool recVaccine, F&& f) {
+    if (susVaccine) {
+        if (recVaccine) f(std::true_type{}, std::true_type{});
+        else            f(std::true_type{}, std::false_type{});
+    } else {
+        if (recVaccine) f(std::false_type{}, std::true_type{});
+        else            f(std::false_type{}, std::false_type{});
+    }
+}
+
+#endif // SIRV_RULES_HPP
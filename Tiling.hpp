@@ -0,0 +1,96 @@
+/**
+ * @file Tiling.hpp
+ * @brief Cache detection and 2D tile decomposition of the n×n grid.
+ */
+
+#ifndef TILING_HPP
+#define TILING_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+/**
+ * @brief A half-open rectangle [i0, i1) × [j0, j1) of grid cells.
+ */
+struct Tile {
+    int i0, i1; /** <Row range */
+    int j0, j1; /** <Column range */
+};
+
+/**
+ * @brief Size in bytes of the per-core L2 cache (or the closest level we can find).
+ *
+ * On POSIX systems uses sysconf where glibc exposes the cache levels, then the Linux sysfs
+ * cache description; elsewhere, or when neither is available, falls back to a conservative
+ * 256 KiB.
+ * @return Cache size in bytes.
+ */
+inline std::size_t detectL2CacheBytes() {
+#if defined(__unix__) || defined(__APPLE__)
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    long bytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if (bytes > 0) return static_cast<std::size_t>(bytes);
+#endif
+    for (int index = 0; index < 8; ++index) {
+        std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+        std::ifstream levelFile(dir + "level");
+        int level = 0;
+        if (!(levelFile >> level)) break;
+        if (level != 2) continue;
+        std::ifstream sizeFile(dir + "size");
+        std::size_t size = 0;
+        char unit = 0;
+        if (sizeFile >> size) {
+            sizeFile >> unit;
+            if (unit == 'K') size *= 1024;
+            else if (unit == 'M') size *= 1024 * 1024;
+            if (size > 0) return size;
+        }
+    }
+#endif
+    return 256 * 1024;
+}
+
+/**
+ * @brief Chooses a square tile side so a tile's working set stays resident in L2.
+ *
+ * Half of L2 is budgeted for the tile, leaving room for the halo rows and whatever else the
+ * step touches (candidate lists, the random generator state).
+ * @param bytesPerCell Bytes read and written per cell during one step.
+ * @return Tile side length in cells, at least 16.
+ */
+inline int autoTileSize(std::size_t bytesPerCell) {
+    static const std::size_t l2 = detectL2CacheBytes();
+    std::size_t cells = (l2 / 2) / std::max<std::size_t>(bytesPerCell, 1);
+    int side = static_cast<int>(std::sqrt(static_cast<double>(cells)));
+    return std::max(side, 16);
+}
+
+/**
+ * @brief Splits an n×n grid into tiles of side @p tile, row-major over tiles.
+ *
+ * The tiles are independent units of work, so the same list can be walked serially or
+ * handed out to worker threads.
+ * @param n Grid side length.
+ * @param tile Tile side length; values <= 0 or >= n give a single tile covering the grid.
+ * @return The tiles covering the grid exactly once.
+ */
+inline std::vector<Tile> makeTiles(int n, int tile) {
+    if (tile <= 0 || tile >= n) return {Tile{0, n, 0, n}};
+    std::vector<Tile> tiles;
+    for (int i0 = 0; i0 < n; i0 += tile) {
+        for (int j0 = 0; j0 < n; j0 += tile) {
+            tiles.push_back(Tile{i0, std::min(i0 + tile, n), j0, std::min(j0 + tile, n)});
+        }
+    }
+    return tiles;
+}
+
+#endif // TILING_HPP
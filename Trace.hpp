@@ -0,0 +1,170 @@
+/**
+ * @file Trace.hpp
+ * @brief Optional Chrome trace-event recorder with per-thread lock-free buffers.
+ */
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class Tracer
+ * @brief Collects complete ("X") trace events and writes them as Chrome trace-event JSON,
+ *        which Perfetto (ui.perfetto.dev) and chrome://tracing open directly.
+ *
+ * Each thread appends to its own fixed-capacity buffer, so recording takes no lock: the
+ * thread writes the slot and then publishes it by bumping an atomic count, which is all the
+ * dumping thread reads. Events beyond a buffer's capacity are dropped and counted. When
+ * tracing is off a scope costs one relaxed atomic load.
+ */
+class Tracer {
+public:
+    using clock = std::chrono::steady_clock;
+
+private:
+    struct Event {
+        const char* name;     /** <Static string naming the span */
+        std::int64_t beginNs; /** <Start, ns since the tracer epoch */
+        std::int64_t endNs;   /** <End, ns since the tracer epoch */
+    };
+
+    struct Buffer {
+        explicit Buffer(std::size_t capacity, int tid) : events(capacity), tid(tid) {}
+        std::vector<Event> events;          /** <Preallocated slots */
+        std::atomic<std::size_t> count{0};  /** <Published events */
+        std::atomic<std::size_t> dropped{0};/** <Events lost to a full buffer */
+        int tid;                            /** <Thread id shown in the trace */
+    };
+
+    std::atomic<bool> _enabled{false};
+    std::size_t _capacity = std::size_t(1) << 18;
+    clock::time_point _epoch = clock::now();
+    std::mutex _mutex;                            /** <Guards _buffers (registration and dump only) */
+    std::vector<std::unique_ptr<Buffer>> _buffers;
+
+    Buffer& localBuffer() {
+        thread_local Buffer* buffer = nullptr;
+        if (!buffer) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _buffers.push_back(std::make_unique<Buffer>(_capacity, static_cast<int>(_buffers.size()) + 1));
+            buffer = _buffers.back().get();
+        }
+        return *buffer;
+    }
+
+public:
+    /**
+     * @brief The process-wide tracer.
+     */
+    static Tracer& global() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    bool enabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Starts recording.
+     * @param eventsPerThread Capacity of each thread's buffer, fixed when the thread first records.
+     */
+    void enable(std::size_t eventsPerThread = std::size_t(1) << 18) {
+        _capacity = eventsPerThread;
+        _enabled.store(true, std::memory_order_relaxed);
+    }
+
+    void disable() { _enabled.store(false, std::memory_order_relaxed); }
+
+    /**
+     * @brief Records one span on the calling thread.
+     * @param name Static string; only the pointer is stored.
+     * @param begin Start of the span.
+     * @param end End of the span.
+     */
+    void record(const char* name, clock::time_point begin, clock::time_point end) {
+        Buffer& b = localBuffer();
+        std::size_t k = b.count.load(std::memory_order_relaxed);
+        if (k >= b.events.size()) {
+            b.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        b.events[k] = Event{name,
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(begin - _epoch).count(),
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(end - _epoch).count()};
+        b.count.store(k + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Writes every published event as a Chrome trace-event JSON file.
+     * @param path Output file.
+     * @return false if the file could not be written.
+     */
+    bool writeJson(const std::string& path) {
+        std::ofstream out(path);
+        if (!out) return false;
+        std::lock_guard<std::mutex> lock(_mutex);
+        out << std::fixed << std::setprecision(3); // microseconds with ns resolution
+        out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+        bool first = true;
+        std::size_t dropped = 0;
+        for (const auto& b : _buffers) {
+            std::size_t count = b->count.load(std::memory_order_acquire);
+            dropped += b->dropped.load(std::memory_order_relaxed);
+            out << (first ? "" : ",\n")
+                << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << b->tid
+                << ", \"args\": {\"name\": \"thread " << b->tid << "\"}}";
+            first = false;
+            for (std::size_t k = 0; k < count; ++k) {
+                const Event& e = b->events[k];
+                out << ",\n{\"name\": \"" << e.name << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << b->tid
+                    << ", \"ts\": " << e.beginNs / 1000.0
+                    << ", \"dur\": " << (e.endNs - e.beginNs) / 1000.0 << "}";
+            }
+        }
+        out << "\n], \"otherData\": {\"dropped_events\": " << dropped << "}}\n";
+        return static_cast<bool>(out);
+    }
+};
+
+/**
+ * @class TraceScope
+ * @brief Records the enclosing scope as one trace span when tracing is enabled.
+ */
+class TraceScope {
+private:
+    const char* _name;
+    bool _active;
+    Tracer::clock::time_point _start;
+
+public:
+    explicit TraceScope(const char* name)
+    : _name(name), _active(Tracer::global().enabled()) {
+        if (_active) _start = Tracer::clock::now();
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    ~TraceScope() {
+        if (_active) Tracer::global().record(_name, _start, Tracer::clock::now());
+    }
+};
+
+#define EPIDEMIC_TRACE_CONCAT2(a, b) a##b
+#define EPIDEMIC_TRACE_CONCAT(a, b) EPIDEMIC_TRACE_CONCAT2(a, b)
+
+/**
+ * @brief Traces the rest of the enclosing scope (without adding a timing phase).
+ */
+#define EPIDEMIC_TRACE_SCOPE(name) TraceScope EPIDEMIC_TRACE_CONCAT(_traceScope, __LINE__)(name)
+
+#endif // TRACE_HPP
@@ -0,0 +1,170 @@
+/**
+ * @file BenchHarness.hpp
+ * @brief A small self-contained microbenchmark runner (no external benchmark library needed).
+ */
+
+#ifndef BENCH_HARNESS_HPP
+#define BENCH_HARNESS_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "PerfCounters.hpp"
+
+/**
+ * @brief Timing of one benchmark case.
+ */
+struct BenchResult {
+    std::string name;          /** <Case name, e.g. "Update/n=300/inf=0.10" */
+    std::size_t iterations;    /** <Timed iterations */
+    double secondsPerIter;     /** <Mean wall time of one iteration */
+    double cellsPerIter;       /** <Cells processed by one iteration */
+    double bytesPerCell;       /** <Memory footprint of the representation per cell */
+    bool hasCounters = false;  /** <Whether hardware counters were collected */
+    PerfSample counters;       /** <Counter totals over all timed iterations */
+
+    /**
+     * @brief A counter total divided by the number of cells processed.
+     */
+    double perCell(double total) const { return total / (cellsPerIter * iterations); }
+};
+
+/**
+ * @class BenchRunner
+ * @brief Runs each case until a minimum wall time has been spent and reports cells/second,
+ *        plus per-cell hardware counters when perf_event_open is available.
+ */
+class BenchRunner {
+private:
+    double _minSeconds;              /** <Minimum timed wall time per case */
+    std::string _filter;             /** <Only cases whose name contains this substring run */
+    std::unique_ptr<PerfCounters> _perf; /** <Hardware counters, or null when disabled */
+    std::vector<BenchResult> _results;
+
+public:
+    /**
+     * @param minSeconds Minimum timed wall time per case.
+     * @param filter Only cases whose name contains this substring run.
+     * @param usePerf Collect hardware counters if the system allows it.
+     */
+    explicit BenchRunner(double minSeconds = 0.5, std::string filter = "", bool usePerf = true)
+    : _minSeconds(minSeconds), _filter(std::move(filter)) {
+        if (usePerf) {
+            _perf = std::make_unique<PerfCounters>();
+            if (!_perf->available()) {
+                std::cerr << "Hardware counters unavailable (perf_event_open refused); timing only.\n";
+                _perf.reset();
+            }
+        }
+    }
+
+    bool countersEnabled() const { return static_cast<bool>(_perf); }
+
+    const std::vector<BenchResult>& results() const { return _results; }
+
+    /**
+     * @brief Times a case; setup() runs untimed before every body() call.
+     * @param name Case name.
+     * @param cells Cells processed per iteration.
+     * @param bytesPerCell Memory footprint per cell, reported alongside the throughput.
+     * @param setup Untimed per-iteration preparation.
+     * @param body The timed work.
+     */
+    template <class Setup, class Body>
+    void run(const std::string& name, double cells, double bytesPerCell, Setup&& setup, Body&& body) {
+        if (!_filter.empty() && name.find(_filter) == std::string::npos) return;
+        using clock = std::chrono::steady_clock;
+        setup();
+        body(); // warm-up
+        std::size_t iterations = 0;
+        double timed = 0.0;
+        PerfSample counters;
+        while (timed < _minSeconds || iterations < 3) {
+            setup();
+            if (_perf) _perf->start();
+            auto t0 = clock::now();
+            body();
+            timed += std::chrono::duration<double>(clock::now() - t0).count();
+            if (_perf) counters += _perf->stop();
+            ++iterations;
+        }
+        BenchResult r{name, iterations, timed / iterations, cells, bytesPerCell,
+                      static_cast<bool>(_perf), counters};
+        _results.push_back(r);
+        print(std::cout, r);
+    }
+
+    /**
+     * @brief Times a case with no per-iteration setup.
+     */
+    template <class Body>
+    void run(const std::string& name, double cells, double bytesPerCell, Body&& body) {
+        run(name, cells, bytesPerCell, [] {}, std::forward<Body>(body));
+    }
+
+    void printHeader(std::ostream& os) const {
+        os << std::left << std::setw(40) << "case"
+           << std::right << std::setw(10) << "iters"
+           << std::setw(14) << "ms/iter"
+           << std::setw(16) << "Mcells/s"
+           << std::setw(12) << "bytes/cell";
+        if (_perf) {
+            os << std::setw(11) << "cyc/cell"
+               << std::setw(8) << "IPC"
+               << std::setw(14) << "LLCmiss/cell"
+               << std::setw(14) << "brmiss/cell";
+        }
+        os << "\n";
+    }
+
+    static void print(std::ostream& os, const BenchResult& r) {
+        os << std::left << std::setw(40) << r.name
+           << std::right << std::setw(10) << r.iterations
+           << std::setw(14) << std::fixed << std::setprecision(3) << r.secondsPerIter * 1e3
+           << std::setw(16) << std::setprecision(2) << r.cellsPerIter / r.secondsPerIter / 1e6
+           << std::setw(12) << std::setprecision(1) << r.bytesPerCell;
+        if (r.hasCounters && r.cellsPerIter > 0) {
+            const PerfSample& c = r.counters;
+            os << std::setw(11) << std::setprecision(1) << r.perCell(c.cycles)
+               << std::setw(8) << std::setprecision(2) << (c.cycles > 0 ? c.instructions / c.cycles : 0.0)
+               << std::setw(14) << std::setprecision(4) << r.perCell(c.llcMisses)
+               << std::setw(14) << std::setprecision(4) << r.perCell(c.branchMisses);
+        }
+        os << "\n";
+    }
+
+    /**
+     * @brief Writes all results as a JSON array.
+     * @param path Output file.
+     * @return false if the file could not be written.
+     */
+    bool writeJson(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) return false;
+        out << "[\n";
+        for (std::size_t k = 0; k < _results.size(); ++k) {
+            const BenchResult& r = _results[k];
+            out << "  {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+                << ", \"seconds_per_iter\": " << r.secondsPerIter
+                << ", \"cells_per_second\": " << r.cellsPerIter / r.secondsPerIter
+                << ", \"bytes_per_cell\": " << r.bytesPerCell;
+            if (r.hasCounters && r.cellsPerIter > 0) {
+                out << ", \"cycles_per_cell\": " << r.perCell(r.counters.cycles)
+                    << ", \"instructions_per_cell\": " << r.perCell(r.counters.instructions)
+                    << ", \"llc_misses_per_cell\": " << r.perCell(r.counters.llcMisses)
+                    << ", \"branch_misses_per_cell\": " << r.perCell(r.counters.branchMisses);
+            }
+            out << "}"
+                << (k + 1 < _results.size() ? ",\n" : "\n");
+        }
+        out << "]\n";
+        return static_cast<bool>(out);
+    }
+};
+
+#endif // BENCH_HARNESS_HPP
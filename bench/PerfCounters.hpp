@@ -0,0 +1,166 @@
+/**
+ * @file PerfCounters.hpp
+ * @brief Hardware performance counters (cycles, instructions, LLC misses, branch misses) via perf_event_open.
+ */
+
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Counter totals for one measured region (scaled for multiplexing).
+ */
+struct PerfSample {
+    double cycles = 0;       /** <CPU cycles */
+    double instructions = 0; /** <Retired instructions */
+    double llcMisses = 0;    /** <Last-level cache misses */
+    double branchMisses = 0; /** <Mispredicted branches */
+
+    PerfSample& operator+=(const PerfSample& o) {
+        cycles += o.cycles;
+        instructions += o.instructions;
+        llcMisses += o.llcMisses;
+        branchMisses += o.branchMisses;
+        return *this;
+    }
+};
+
+/**
+ * @class PerfCounters
+ * @brief A group of user-space hardware counters for the calling thread and the threads it creates.
+ *
+ * The four events are opened as one group so they are scheduled together, with inherit set so
+ * that worker threads started after construction (the OpenMP pool of the network and
+ * multi-strain cases) are counted too. The kernel does not allow group reads of inherited
+ * counters, so each counter is read on its own, and a measurement is the difference between
+ * the readings at start() and stop(), including the enabled/running times used to scale for
+ * multiplexing (PERF_EVENT_IOC_RESET would not reset those). If the kernel or
+ * the environment does not allow it (non-Linux, containers, perf_event_paranoid > 2) the
+ * object reports available() == false and start()/stop() do nothing.
+ */
+class PerfCounters {
+private:
+    static constexpr int kEvents = 4;
+    int _fd[kEvents] = {-1, -1, -1, -1};
+    bool _available = false;
+
+    /**
+     * @brief One counter's value with the times it was enabled and actually counting.
+     */
+    struct Reading {
+        std::uint64_t value = 0;
+        std::uint64_t timeEnabled = 0;
+        std::uint64_t timeRunning = 0;
+    };
+    Reading _start[kEvents];
+
+    bool readAll(Reading (&out)[kEvents]) const {
+#ifdef __linux__
+        for (int k = 0; k < kEvents; ++k) {
+            if (read(_fd[k], &out[k], sizeof(Reading)) != static_cast<ssize_t>(sizeof(Reading))) return false;
+        }
+        return true;
+#else
+        (void)out;
+        return false;
+#endif
+    }
+
+#ifdef __linux__
+    static int open(std::uint64_t config, int group) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = group == -1 ? 1 : 0; // the leader starts the whole group
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.inherit = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+    }
+#endif
+
+public:
+    PerfCounters() {
+#ifdef __linux__
+        const std::uint64_t configs[kEvents] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES
+        };
+        for (int k = 0; k < kEvents; ++k) {
+            _fd[k] = open(configs[k], k == 0 ? -1 : _fd[0]);
+            if (_fd[k] < 0) {
+                for (int m = 0; m < k; ++m) close(_fd[m]);
+                for (int& fd : _fd) fd = -1;
+                return;
+            }
+        }
+        _available = true;
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (int fd : _fd) {
+            if (fd >= 0) close(fd);
+        }
+#endif
+    }
+
+    bool available() const { return _available; }
+
+    /**
+     * @brief Takes the starting readings and starts the counters.
+     */
+    void start() {
+#ifdef __linux__
+        if (!_available) return;
+        if (!readAll(_start)) return;
+        ioctl(_fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    /**
+     * @brief Stops the counters and returns the counts since start().
+     */
+    PerfSample stop() {
+        PerfSample s;
+#ifdef __linux__
+        if (!_available) return s;
+        ioctl(_fd[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        Reading end[kEvents];
+        if (!readAll(end)) return s;
+        double values[kEvents];
+        for (int k = 0; k < kEvents; ++k) {
+            //scale up if the counter was multiplexed off the PMU part of this interval
+            const std::uint64_t enabled = end[k].timeEnabled - _start[k].timeEnabled;
+            const std::uint64_t running = end[k].timeRunning - _start[k].timeRunning;
+            const double scale = running > 0 ? static_cast<double>(enabled) / static_cast<double>(running) : 0.0;
+            values[k] = static_cast<double>(end[k].value - _start[k].value) * scale;
+        }
+        s.cycles       = values[0];
+        s.instructions = values[1];
+        s.llcMisses    = values[2];
+        s.branchMisses = values[3];
+#endif
+        return s;
+    }
+};
+
+#endif // PERF_COUNTERS_HPP
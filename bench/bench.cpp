@@ -0,0 +1,348 @@
+/**
+ * @file bench.cpp
+ * @brief Microbenchmarks for the simulation step, the contact-network, event-driven, incremental, multi-strain and memory-mapped engines, state counting, the display pyramid, rendering, frame capture and CSV output.
+ *
+ * The rendering and frame-capture cases are only built when the visualization is
+ * (EPIDEMIC_BENCH_GRAPHICS).
+ *
+ * Usage: epidemic_bench [filter] [--min-time seconds] [--json file] [--no-perf]
+ *
+ * On Linux, cycles, instructions, LLC misses and branch misses per cell are reported next to
+ * the timings when perf_event_open is permitted (see /proc/sys/kernel/perf_event_paranoid).
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include "BenchHarness.hpp"
+#include "../Population.hpp"
+#include "../ContactNetwork.hpp"
+#include "../NextReaction.hpp"
+#include "../IncrementalPopulation.hpp"
+#include "../MultiStrain.hpp"
+#include "../LodPyramid.hpp"
+#if defined(__unix__) || defined(__APPLE__)
+#include "../MappedPopulation.hpp"
+#endif
+#ifdef EPIDEMIC_BENCH_GRAPHICS
+#include "../PopulationView.hpp"
+#endif
+
+/**
+ * @brief Builds a seeded n×n population with roughly the given fraction infected.
+ * @param n Grid side length.
+ * @param infected Fraction of cells to infect.
+ * @return The population.
+ */
+Population makePopulation(int n, double infected)
+{
+    Population pop(n, 12345);
+    std::mt19937 rng(678);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            if (dist(rng) < infected) pop.set_inf(i, j);
+        }
+    }
+    return pop;
+}
+
+/**
+ * @brief Ring lattice with each vertex linked to `links` random vertices within `reach` of it,
+ *        with ids shuffled so the input order has no locality.
+ */
+ContactGraph makeContactGraph(std::int32_t n, int links, std::int32_t reach)
+{
+    std::mt19937 rng(91);
+    std::vector<std::int32_t> id(n);
+    for (std::int32_t v = 0; v < n; ++v) id[v] = v;
+    std::shuffle(id.begin(), id.end(), rng);
+    std::vector<ContactGraph::Edge> edges;
+    edges.reserve(static_cast<std::size_t>(n) * links);
+    for (std::int32_t v = 0; v < n; ++v) {
+        for (int k = 0; k < links; ++k) {
+            std::int32_t u = static_cast<std::int32_t>((v + 1 + rng() % reach) % n);
+            edges.emplace_back(id[v], id[u]);
+        }
+    }
+    return ContactGraph::fromEdges(n, edges);
+}
+
+/**
+ * @brief Memory footprint of the string-based grid, per cell.
+ */
+double populationBytesPerCell(int n)
+{
+    double bytes = n * sizeof(std::vector<Person>) + double(n) * n * sizeof(Person);
+    return bytes / (double(n) * n);
+}
+
+int main(int argc, char** argv)
+{
+    std::string filter;
+    std::string jsonPath;
+    double minTime = 0.5;
+    bool usePerf = true;
+    for (int a = 1; a < argc; ++a) {
+        std::string arg = argv[a];
+        if (arg == "--min-time" && a + 1 < argc) minTime = std::atof(argv[++a]);
+        else if (arg == "--json" && a + 1 < argc) jsonPath = argv[++a];
+        else if (arg == "--no-perf") usePerf = false;
+        else filter = arg;
+    }
+
+    PhaseTimings::global().setEnabled(false); // keep the phase timers out of the measurements
+    BenchRunner runner(minTime, filter, usePerf);
+    runner.printHeader(std::cout);
+
+    const int sizes[] = {100, 300, 1000};
+    const double densities[] = {0.01, 0.10, 0.50};
+
+    for (int n : sizes) {
+        const double cells = double(n) * n;
+        const double bytes = populationBytesPerCell(n);
+        for (double d : densities) {
+            std::ostringstream suffix;
+            suffix << "/n=" << n << "/inf=" << std::fixed << std::setprecision(2) << d;
+            const Population base = makePopulation(n, d);
+            Population work = base;
+
+            runner.run("Update" + suffix.str(), cells, bytes,
+                       [&] { work = base; }, [&] { work.Update(); });
+            runner.run("advance(1)" + suffix.str(), cells, bytes,
+                       [&] { work = base; }, [&] { work.advance(1); });
+        }
+
+        for (Boundary b : {Boundary::Periodic, Boundary::Reflecting}) {
+            const std::string name = b == Boundary::Periodic ? "periodic" : "reflecting";
+            Population bounded = makePopulation(n, 0.10);
+            bounded.setBoundary(b);
+            Population boundedWork = bounded;
+            runner.run("Update/" + name + "/n=" + std::to_string(n) + "/inf=0.10", cells, bytes,
+                       [&] { boundedWork = bounded; }, [&] { boundedWork.Update(); });
+        }
+
+        //box neighborhoods count infected cells from a summed-area table of int32
+        const std::pair<std::string, Neighborhood> neighborhoods[] = {
+            {"moore1", Neighborhood::moore(1)},
+            {"moore50", Neighborhood::moore(50)},
+            {"weighted20", Neighborhood::distanceWeighted(20, [](int d) { return 1.0f / (d * d); })},
+        };
+        for (const auto& nb : neighborhoods) {
+            Population wide = makePopulation(n, 0.10);
+            wide.setNeighborhood(nb.second);
+            Population wideWork = wide;
+            runner.run("Update/" + nb.first + "/n=" + std::to_string(n) + "/inf=0.10", cells, bytes + 4.0,
+                       [&] { wideWork = wide; }, [&] { wideWork.Update(); });
+        }
+
+        Population aged = makePopulation(n, 0.10);
+        aged.setInfectiousPeriod(InfectiousPeriod::gamma(4.0, 20.0));
+        Population agedWork = aged;
+        runner.run("Update/ageTracked/n=" + std::to_string(n) + "/inf=0.10", cells, bytes + 2.0,
+                   [&] { agedWork = aged; }, [&] { agedWork.Update(); });
+
+        const Population pop = makePopulation(n, 0.10);
+        runner.run("countStates/n=" + std::to_string(n), cells, bytes, [&] {
+            volatile int sink = pop.countStates().infected;
+            (void)sink;
+        });
+    }
+
+    {
+        //a grid far larger than L2: row-major sweep versus cache-sized tiles
+        const int n = 2000;
+        const double cells = double(n) * n;
+        const Population base = makePopulation(n, 0.10);
+        Population work = base;
+        runner.run("Update/untiled/n=2000/inf=0.10", cells, populationBytesPerCell(n),
+                   [&] { work = base; work.setTileSize(0); }, [&] { work.Update(); });
+        runner.run("Update/autoTile/n=2000/inf=0.10", cells, populationBytesPerCell(n),
+                   [&] { work = base; work.useAutoTileSize(); }, [&] { work.Update(); });
+    }
+
+    {
+        //long-range contacts on a large grid, one per infected cell per day
+        const int n = 2000;
+        const double cells = double(n) * n;
+        const Population base = makePopulation(n, 0.10);
+        Population work = base;
+        runner.run("Update/mobility=uniform/n=2000/inf=0.10", cells, populationBytesPerCell(n),
+                   [&] { work = base; work.setMobility(MobilityLayer::uniform(1.0, 0.5)); },
+                   [&] { work.Update(); });
+        runner.run("Update/mobility=powerLaw/n=2000/inf=0.10", cells, populationBytesPerCell(n),
+                   [&] { work = base; work.setMobility(MobilityLayer::powerLaw(1.0, 0.5)); },
+                   [&] { work.Update(); });
+    }
+
+    {
+        const std::int32_t n = 1000000;
+        const ContactGraph graph = makeContactGraph(n, 5, 200);
+        //state bytes plus CSR neighbor ids and offsets
+        const double bytes = 2.0 + (4.0 * graph.adjacency().size() + 8.0 * (n + 1)) / n;
+        for (bool reorder : {false, true}) {
+            const std::string name = std::string("NetworkPopulation::step/") + (reorder ? "rcm" : "input-order");
+            NetworkPopulation pop(graph, 12345, SirvRates{}, reorder);
+            for (std::int32_t v = 0; v < n; v += 10) pop.setState(v, CellState::Infected);
+            const NetworkPopulation base = pop;
+            runner.run(name, n, bytes, [&] { pop = base; }, [&] { pop.step(); });
+        }
+    }
+
+    for (int strains : {1, 3}) {
+        const int n = 1000;
+        MultiStrainPopulation pop(n, strains, 12345);
+        std::mt19937 rng(678);
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                if (dist(rng) < 0.10) pop.infect(i, j, (i + j) % strains);
+            }
+        }
+        const MultiStrainPopulation base = pop;
+        runner.run("MultiStrainPopulation::step/n=1000/K=" + std::to_string(strains), double(n) * n, 2.0,
+                   [&] { pop = base; }, [&] { pop.step(); });
+    }
+
+    {
+        //a sparse epidemic on a large grid: the event-driven engine only pays for the events
+        const int n = 1000;
+        const double cells = double(n) * n;
+        NextReactionEngine engine(n, 12345);
+        IncrementalPopulation incremental(n, 12345);
+        Population pop(n, 12345);
+        for (int k = 0; k < 100; ++k) {
+            engine.setState((k * 7919) % n, (k * 104729) % n, CellState::Infected);
+            incremental.setState((k * 7919) % n, (k * 104729) % n, CellState::Infected);
+            pop.set_inf((k * 7919) % n, (k * 104729) % n);
+        }
+        engine.advance(1); // time the initial queue build outside the measurement
+        const NextReactionEngine engineBase = engine;
+        const Population popBase = pop;
+        const IncrementalPopulation incrementalBase = incremental;
+        runner.run("sparse/Update/n=1000", cells, populationBytesPerCell(n),
+                   [&] { pop = popBase; }, [&] { pop.Update(); });
+        runner.run("sparse/NextReactionEngine::advance(1)/n=1000", cells, 1.0 + 4.0,
+                   [&] { engine = engineBase; }, [&] { engine.advance(1); });
+        runner.run("sparse/IncrementalPopulation::step/n=1000", cells, 1.0 + 1.0 + 4.0 + 4.0,
+                   [&] { incremental = incrementalBase; }, [&] { incremental.step(); });
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    {
+        //the out-of-core engine, stepped after a checkpoint round trip: the reopened file must
+        //carry the day and counts it was closed with
+        const std::int64_t n = 2000;
+        const double cells = double(n) * n;
+        const std::string path = (std::filesystem::temp_directory_path() / "epidemic_bench_grid.sirv").string();
+        MappedPopulation::Counts closed;
+        std::int64_t closedDay = 0;
+        {
+            MappedPopulation grid(path, n, 12345);
+            std::mt19937 rng(678);
+            std::uniform_real_distribution<double> dist(0.0, 1.0);
+            for (std::int64_t i = 0; i < n; ++i) {
+                for (std::int64_t j = 0; j < n; ++j) {
+                    if (dist(rng) < 0.10) grid.setState(i, j, CellState::Infected);
+                }
+            }
+            grid.advance(3);
+            closed = grid.countStates();
+            closedDay = grid.day();
+        }
+        MappedPopulation grid(path);
+        const MappedPopulation::Counts reopened = grid.countStates();
+        if (grid.day() != closedDay || reopened.infected != closed.infected ||
+            reopened.recovered != closed.recovered || reopened.susceptible != closed.susceptible) {
+            std::cerr << "Error: " << path << " did not reopen with the state it was closed with.\n";
+            return 1;
+        }
+        runner.run("MappedPopulation::step/n=2000", cells, 2.0, [&] { grid.step(); });
+        runner.run("MappedPopulation::reopen/n=2000", cells, 0.0, [&] {
+            MappedPopulation again(path);
+            volatile std::int64_t sink = again.countStates().infected;
+            (void)sink;
+        });
+        std::filesystem::remove(path);
+    }
+#endif
+
+    {
+        //keeping the display pyramid current: one day's transitions versus a rebuild
+        const int n = 1000;
+        Population pop = makePopulation(n, 0.10);
+        const std::vector<std::uint8_t> codes = pop.stateCodes();
+        pop.recordTransitions(true);
+        pop.Update();
+        const std::vector<CellTransition> day = pop.transitions();
+        const LodPyramid base(n, codes);
+        LodPyramid pyramid = base;
+        runner.run("LodPyramid::apply/n=1000/oneDay", double(day.size()), 0.0,
+                   [&] { pyramid = base; }, [&] { pyramid.apply(day); });
+        runner.run("LodPyramid::assign/n=1000", double(n) * n, 1.0,
+                   [&] { pyramid.assign(n, codes); });
+    }
+
+#ifdef EPIDEMIC_BENCH_GRAPHICS
+    // Rendering and capture need a GL context; skip them on headless machines.
+    const float cellSize = 20;
+    const float gap = 1;
+    for (int n : {50, 100}) {
+        const Population pop = makePopulation(n, 0.10);
+        const unsigned px = static_cast<unsigned>(gap + n * (cellSize + gap));
+        sf::RenderTexture target;
+        if (!target.resize({px, px})) {
+            std::cerr << "Skipping render benchmarks: no render context available.\n";
+            break;
+        }
+        const double cells = double(n) * n;
+        const double pixelBytesPerCell = 4.0 * px * px / cells;
+
+        runner.run("draw/n=" + std::to_string(n), cells, pixelBytesPerCell, [&] {
+            drawPopulation(target, pop, cellSize, gap);
+            target.display();
+        });
+
+        runner.run("captureFrame/n=" + std::to_string(n), cells, pixelBytesPerCell, [&] {
+            sf::Image image = target.getTexture().copyToImage();
+            (void)image;
+        });
+
+        const std::string png = (std::filesystem::temp_directory_path() / "epidemic_bench_frame.png").string();
+        sf::Image image = target.getTexture().copyToImage();
+        runner.run("savePng/n=" + std::to_string(n), cells, pixelBytesPerCell, [&] {
+            if (!image.saveToFile(png)) std::cerr << "Failed to save " << png << "\n";
+        });
+        std::filesystem::remove(png);
+    }
+#endif
+
+    {
+        const int rows = 1000;
+        const std::string path = (std::filesystem::temp_directory_path() / "epidemic_bench_counts.csv").string();
+        const Population::Counts c = makePopulation(100, 0.10).countStates();
+        runner.run("csvWrite/rows=" + std::to_string(rows), rows, 0.0, [&] {
+            std::ofstream csv(path);
+            csv << "step,susceptible,infected,recovered,vaccinated\n";
+            for (int step = 0; step < rows; ++step) {
+                csv << step << ','
+                    << c.susceptible << ','
+                    << c.infected    << ','
+                    << c.recovered   << ','
+                    << c.vaccinated  << '\n';
+            }
+        });
+        std::filesystem::remove(path);
+    }
+
+    if (!jsonPath.empty() && !runner.writeJson(jsonPath)) {
+        std::cerr << "Error: could not write " << jsonPath << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file perfcheck.cpp
+ * @brief Performance regression gate: runs fixed seeded workloads and compares steps/second to a stored baseline.
+ *
+ * Usage: epidemic_perfcheck --baseline file [--tolerance fraction] [--write-baseline]
+ *
+ * Exits with status 1 if any workload is slower than baseline * (1 - tolerance). Baselines are
+ * machine specific; regenerate them with --write-baseline on the reference machine.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../Population.hpp"
+
+/**
+ * @brief A deterministic workload: a fixed-seed population advanced a fixed number of steps.
+ */
+struct Workload {
+    std::string name;                       /** <Key in the baseline file */
+    int n;                                  /** <Grid side length */
+    int calls;                              /** <Calls of step per repetition */
+    int daysPerCall;                        /** <Days one call of step advances */
+    std::function<void(Population&)> step;  /** <One call of the workload */
+};
+
+/**
+ * @brief Seeded n×n population with the central half of the grid 75% infected, like main().
+ */
+Population seededPopulation(int n)
+{
+    Population pop(n, 2024);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(0.0, 1.0);
+    for (int i = n / 4; i < 3 * n / 4; ++i) {
+        for (int j = n / 4; j < 3 * n / 4; ++j) {
+            if (dist(rng) < 0.75f) pop.set_inf(i, j);
+        }
+    }
+    return pop;
+}
+
+/**
+ * @brief Best-of-repetitions simulated days (steps) per second, which is far less noisy than the mean.
+ */
+double measure(const Workload& w, int repetitions)
+{
+    using clock = std::chrono::steady_clock;
+    double best = 0.0;
+    for (int r = 0; r < repetitions; ++r) {
+        Population pop = seededPopulation(w.n);
+        auto t0 = clock::now();
+        for (int c = 0; c < w.calls; ++c) w.step(pop);
+        double seconds = std::chrono::duration<double>(clock::now() - t0).count();
+        best = std::max(best, w.calls * w.daysPerCall / seconds);
+    }
+    return best;
+}
+
+/**
+ * @brief Reads every "key": number pair of a flat baseline JSON file.
+ */
+std::map<std::string, double> readBaseline(const std::string& path, bool& ok)
+{
+    std::map<std::string, double> values;
+    std::ifstream in(path);
+    ok = static_cast<bool>(in);
+    if (!ok) return values;
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    const std::string text = buffer.str();
+    const std::regex pair("\"([^\"]+)\"\\s*:\\s*([-+0-9.eE]+)");
+    for (auto it = std::sregex_iterator(text.begin(), text.end(), pair); it != std::sregex_iterator(); ++it) {
+        values[(*it)[1]] = std::atof((*it)[2].str().c_str());
+    }
+    return values;
+}
+
+int main(int argc, char** argv)
+{
+    std::string baselinePath;
+    double tolerance = -1.0;
+    bool writeBaseline = false;
+    for (int a = 1; a < argc; ++a) {
+        std::string arg = argv[a];
+        if (arg == "--baseline" && a + 1 < argc) baselinePath = argv[++a];
+        else if (arg == "--tolerance" && a + 1 < argc) tolerance = std::atof(argv[++a]);
+        else if (arg == "--write-baseline") writeBaseline = true;
+        else {
+            std::cerr << "Usage: " << argv[0] << " --baseline file [--tolerance fraction] [--write-baseline]\n";
+            return 2;
+        }
+    }
+    if (baselinePath.empty()) {
+        std::cerr << "Error: --baseline is required.\n";
+        return 2;
+    }
+
+    PhaseTimings::global().setEnabled(false);
+
+    const std::vector<Workload> workloads = {
+        {"Update/n=200",      200,  40, 1, [](Population& p) { p.Update(); }},
+        {"Update/n=1000",     1000, 4,  1, [](Population& p) { p.Update(); }},
+        {"advance(1)/n=1000", 1000, 8,  1, [](Population& p) { p.advance(1); }},
+        {"advance(8)/n=1000", 1000, 2,  8, [](Population& p) { p.advance(8); }},
+    };
+    const int repetitions = 3;
+
+    std::map<std::string, double> measured;
+    for (const Workload& w : workloads) {
+        measured[w.name] = measure(w, repetitions);
+    }
+
+    if (writeBaseline) {
+        std::ofstream out(baselinePath);
+        if (!out) {
+            std::cerr << "Error: could not write " << baselinePath << "\n";
+            return 2;
+        }
+        out << "{\n  \"tolerance\": " << (tolerance >= 0.0 ? tolerance : 0.25) << ",\n"
+            << "  \"steps_per_second\": {\n";
+        for (std::size_t k = 0; k < workloads.size(); ++k) {
+            out << "    \"" << workloads[k].name << "\": " << std::fixed << std::setprecision(3)
+                << measured[workloads[k].name] << (k + 1 < workloads.size() ? ",\n" : "\n");
+        }
+        out << "  }\n}\n";
+        std::cout << "Wrote baseline " << baselinePath << "\n";
+        return 0;
+    }
+
+    bool ok = false;
+    std::map<std::string, double> baseline = readBaseline(baselinePath, ok);
+    if (!ok) {
+        std::cerr << "Error: could not read baseline " << baselinePath << "\n";
+        return 2;
+    }
+    if (tolerance < 0.0) tolerance = baseline.count("tolerance") ? baseline["tolerance"] : 0.25;
+
+    bool regressed = false;
+    std::cout << std::left << std::setw(22) << "workload"
+              << std::right << std::setw(14) << "baseline" << std::setw(14) << "measured"
+              << std::setw(10) << "ratio" << "\n";
+    for (const Workload& w : workloads) {
+        auto it = baseline.find(w.name);
+        if (it == baseline.end()) {
+            std::cout << std::left << std::setw(22) << w.name << "  (no baseline)\n";
+            continue;
+        }
+        double ratio = measured[w.name] / it->second;
+        bool slow = ratio < 1.0 - tolerance;
+        regressed = regressed || slow;
+        std::cout << std::left << std::setw(22) << w.name
+                  << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(14) << it->second << std::setw(14) << measured[w.name]
+                  << std::setw(10) << ratio << (slow ? "  REGRESSION" : "") << "\n";
+    }
+
+    if (regressed) {
+        std::cerr << "Performance regression: steps/second fell more than "
+                  << tolerance * 100 << "% below baseline.\n";
+        return 1;
+    }
+    std::cout << "All workloads within " << tolerance * 100 << "% of baseline.\n";
+    return 0;
+}
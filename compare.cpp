@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "Population.hpp"
+#include "NextReaction.hpp"
+
+/**
+ * @brief Mean per-day state counts of one engine over all replicates.
+ */
+struct Trajectory {
+    std::vector<double> s, i, r, v; /** <Index = day */
+    double peakInfected = 0.0;      /** <Mean over replicates of the largest infected count */
+    double peakDay = 0.0;           /** <Mean over replicates of the day of that peak */
+    double seconds = 0.0;           /** <Total wall time of the runs */
+
+    explicit Trajectory(int days) : s(days + 1), i(days + 1), r(days + 1), v(days + 1) {}
+};
+
+/**
+ * @brief Infects the central half of the grid with probability 0.75, like main().
+ */
+template <class SetInfected>
+void seedInfection(int n, std::uint64_t seed, SetInfected&& infect)
+{
+    std::mt19937 rng(static_cast<std::mt19937::result_type>(seed));
+    std::uniform_real_distribution<float> dist(0.0, 1.0);
+    for (int i = n / 4; i < 3 * n / 4; ++i) {
+        for (int j = n / 4; j < 3 * n / 4; ++j) {
+            if (dist(rng) < 0.75f) infect(i, j);
+        }
+    }
+}
+
+/**
+ * @brief Runs one engine for every replicate and accumulates its mean trajectory.
+ * @param run Called with (replicate seed, record), must call record(day, s, i, r, v) for days 0 .. days.
+ */
+template <class Run>
+Trajectory collect(int days, int replicates, std::uint64_t seed, Run&& run)
+{
+    Trajectory t(days);
+    auto start = std::chrono::steady_clock::now();
+    for (int rep = 0; rep < replicates; ++rep) {
+        double peak = -1.0;
+        int peakDay = 0;
+        run(seed + rep, [&](int day, double s, double i, double r, double v) {
+            t.s[day] += s / replicates;
+            t.i[day] += i / replicates;
+            t.r[day] += r / replicates;
+            t.v[day] += v / replicates;
+            if (i > peak) { peak = i; peakDay = day; }
+        });
+        t.peakInfected += peak / replicates;
+        t.peakDay += static_cast<double>(peakDay) / replicates;
+    }
+    t.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return t;
+}
+
+/**
+ * @brief Compares the discrete-day engine (Population::Update) with the continuous-time
+ *        next-reaction engine on the same initial condition and rates.
+ *
+ * Usage: epidemic_compare [gridSize] [days] [replicates] [seed]
+ *
+ * Writes the per-day mean counts of both engines to engine_comparison.csv and prints the mean
+ * peak, the final state and the largest per-day gap between the mean curves as a fraction of
+ * the grid.
+ * @return int
+ */
+int main(int argc, char** argv)
+{
+    const int           gridSize   = argc > 1 ? std::atoi(argv[1]) : 100;
+    const int           days       = argc > 2 ? std::atoi(argv[2]) : 600;
+    const int           replicates = argc > 3 ? std::atoi(argv[3]) : 20;
+    const std::uint64_t seed       = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1;
+    if (gridSize <= 0 || days < 0 || replicates <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [gridSize] [days] [replicates] [seed]\n";
+        return 1;
+    }
+    PhaseTimings::global().setEnabled(false);
+
+    Trajectory discrete = collect(days, replicates, seed, [&](std::uint64_t s, auto&& record) {
+        Population pop(gridSize, s);
+        seedInfection(gridSize, s, [&](int i, int j) { pop.set_inf(i, j); });
+        for (int day = 0; day <= days; ++day) {
+            if (day > 0) pop.Update();
+            Population::Counts c = pop.countStates();
+            record(day, c.susceptible, c.infected, c.recovered, c.vaccinated);
+        }
+    });
+
+    Trajectory continuous = collect(days, replicates, seed, [&](std::uint64_t s, auto&& record) {
+        NextReactionEngine engine(gridSize, s, SirvRates{});
+        seedInfection(gridSize, s, [&](int i, int j) { engine.setState(i, j, CellState::Infected); });
+        for (int day = 0; day <= days; ++day) {
+            if (day > 0) engine.advanceTo(day);
+            NextReactionEngine::Counts c = engine.countStates();
+            record(day, c.susceptible, c.infected, c.recovered, c.vaccinated);
+        }
+    });
+
+    std::ofstream csv("engine_comparison.csv");
+    if (!csv) {
+        std::cerr << "Error: could not open engine_comparison.csv for writing.\n";
+        return 1;
+    }
+    csv << "day,discrete_susceptible,discrete_infected,discrete_recovered,discrete_vaccinated,"
+           "continuous_susceptible,continuous_infected,continuous_recovered,continuous_vaccinated\n";
+    const double cells = double(gridSize) * gridSize;
+    double gap = 0.0;
+    int gapDay = 0;
+    for (int day = 0; day <= days; ++day) {
+        csv << day << ',' << discrete.s[day] << ',' << discrete.i[day] << ',' << discrete.r[day] << ',' << discrete.v[day]
+            << ',' << continuous.s[day] << ',' << continuous.i[day] << ',' << continuous.r[day] << ',' << continuous.v[day] << '\n';
+        double d = std::max({std::abs(discrete.s[day] - continuous.s[day]), std::abs(discrete.i[day] - continuous.i[day]),
+                             std::abs(discrete.r[day] - continuous.r[day]), std::abs(discrete.v[day] - continuous.v[day])});
+        if (d > gap) { gap = d; gapDay = day; }
+    }
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "Grid " << gridSize << "x" << gridSize << ", " << days << " days, " << replicates << " replicates\n"
+              << std::left << std::setw(12) << "engine" << std::right
+              << std::setw(12) << "peak I" << std::setw(10) << "peak day"
+              << std::setw(10) << "final S" << std::setw(10) << "final I" << std::setw(10) << "final R"
+              << std::setw(10) << "final V" << std::setw(10) << "seconds" << "\n";
+    auto row = [&](const char* name, const Trajectory& t) {
+        std::cout << std::left << std::setw(12) << name << std::right
+                  << std::setw(12) << t.peakInfected << std::setw(10) << t.peakDay
+                  << std::setw(10) << t.s[days] << std::setw(10) << t.i[days] << std::setw(10) << t.r[days]
+                  << std::setw(10) << t.v[days] << std::setw(10) << std::setprecision(3) << t.seconds
+                  << std::setprecision(1) << "\n";
+    };
+    row("discrete", discrete);
+    row("continuous", continuous);
+    std::cout << std::setprecision(2) << "Largest gap between the mean curves: " << 100.0 * gap / cells
+              << "% of the grid (day " << gapDay << "); per-day means in engine_comparison.csv\n";
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include "EventLog.hpp"
+#include "Population.hpp"
+#include "PhaseTimer.hpp"
+#include "Trace.hpp"
+
+/**
+ * @brief Runs the disease spread model without any graphics and writes the per-step state counts.
+ *
+ * Usage: epidemic_headless [gridSize] [steps] [seed]
+ *
+ * Starts from the same initial condition as the visual simulation (the central half of the
+ * grid infected with probability 0.75) and writes state_counts.csv in the working directory.
+ * Set EPIDEMIC_EVENT_LOG=path to also record every transition for epidemic_replay, and
+ * EPIDEMIC_BOUNDARY=closed|periodic|reflecting to choose the grid edge (default closed).
+ * @return int
+ */
+int main(int argc, char** argv)
+{
+    const int           gridSize = argc > 1 ? std::atoi(argv[1]) : 100;
+    const int           maxSteps = argc > 2 ? std::atoi(argv[2]) : 1000;
+    const std::uint64_t seed     = argc > 3 ? std::strtoull(argv[3], nullptr, 10)
+                                            : std::random_device{}();
+    if (gridSize <= 0 || maxSteps < 0) {
+        std::cerr << "Usage: " << argv[0] << " [gridSize] [steps] [seed]\n";
+        return 1;
+    }
+
+    const char* tracePath = std::getenv("EPIDEMIC_TRACE");
+    if (tracePath) {
+        Tracer::global().enable();
+    }
+
+    Population pop(gridSize, seed);
+
+    if (const char* boundary = std::getenv("EPIDEMIC_BOUNDARY")) {
+        const std::string name = boundary;
+        if (name == "closed") pop.setBoundary(Boundary::Closed);
+        else if (name == "periodic") pop.setBoundary(Boundary::Periodic);
+        else if (name == "reflecting") pop.setBoundary(Boundary::Reflecting);
+        else {
+            std::cerr << "Error: EPIDEMIC_BOUNDARY must be closed, periodic or reflecting, not " << name << "\n";
+            return 1;
+        }
+    }
+
+    std::mt19937 rng(static_cast<std::mt19937::result_type>(seed));
+    std::uniform_real_distribution<float> dist(0.0, 1.0);
+
+    float infectionProbability = 0.75;
+
+    int start = gridSize / 4;
+    int end   = 3 * gridSize / 4;
+
+    for (int i = start; i < end; ++i) {
+        for (int j = start; j < end; ++j) {
+            if (dist(rng) < infectionProbability) {
+                pop.set_inf(i, j);
+            }
+        }
+    }
+
+    std::ofstream csv("state_counts.csv");
+    if (!csv) {
+        std::cerr << "Error: could not open state_counts.csv for writing.\n";
+        return 1;
+    }
+    csv << "step,susceptible,infected,recovered,vaccinated\n";
+
+    const char* eventLogPath = std::getenv("EPIDEMIC_EVENT_LOG");
+    std::unique_ptr<EventLogWriter> eventLog;
+    if (eventLogPath) {
+        try {
+            eventLog = std::make_unique<EventLogWriter>(eventLogPath, gridSize, pop.stateCodes());
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+        pop.recordTransitions(true);
+    }
+
+    for (int step = 0; step <= maxSteps; ++step) {
+        if (step > 0) {
+            EPIDEMIC_PHASE("main/update");
+            pop.Update();
+        }
+        if (eventLog && step > 0) {
+            EPIDEMIC_PHASE("main/eventLog");
+            eventLog->append(pop.day(), pop.transitions());
+            pop.clearTransitions();
+        }
+        EPIDEMIC_PHASE("main/csv");
+        Population::Counts c = pop.countStates();
+        csv << step << ','
+            << c.susceptible << ','
+            << c.infected    << ','
+            << c.recovered   << ','
+            << c.vaccinated  << '\n';
+    }
+
+    if (eventLog && !eventLog->close()) {
+        std::cerr << "Error: could not write event log '" << eventLogPath << "'.\n";
+        return 1;
+    }
+
+    std::cout << "Simulated " << maxSteps << " steps of a " << gridSize << "x" << gridSize
+              << " grid (seed " << seed << "); counts written to state_counts.csv\n";
+
+    PhaseTimings::global().report(std::cout);
+    if (const char* timingsPath = std::getenv("EPIDEMIC_TIMINGS_JSON")) {
+        if (!PhaseTimings::global().writeJson(timingsPath)) {
+            std::cerr << "Error: could not write timings to '" << timingsPath << "'.\n";
+        }
+    }
+    if (tracePath && !Tracer::global().writeJson(tracePath)) {
+        std::cerr << "Error: could not write trace to '" << tracePath << "'.\n";
+    }
+
+    return 0;
+}
@@ -6,102 +6,48 @@
 #include <optional>
 #include <filesystem>   
 #include <random>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include "CountHistory.hpp"
+#include "FrameScheduler.hpp"
+#include "LodPyramid.hpp"
 #include "Population.hpp"
-
-/**
- * @brief Draws the legend for the visualization
- * @param window RenderWindow to draw into
- * @param font The font of text
- * @param pop The object ofht population class being rendered
- * @param gridPixelSize the size length of each grid squar in pixels
- * @param step
- */
-void drawLegend(sf::RenderWindow& window,
-                const sf::Font& font,
-                const Population& pop,
-                float gridPixelSize,
-                int step)
-{
-    const float panelX = gridPixelSize + 20.f;
-    float y = 20.f;
-
-    if (!font.getInfo().family.empty()) {
-        sf::Text title(font);
-        title.setString("Legend");
-        title.setCharacterSize(20);
-        title.setFillColor(sf::Color::White);
-        title.setPosition({panelX, y});
-        window.draw(title);
-    }
-    y += 40.f;
-
-    auto stateColor = [](const std::string& s) {
-        if (s == "infected")    return sf::Color(255, 182, 193);
-        if (s == "recovered")   return sf::Color(173, 216, 230);
-        if (s == "susceptible") return sf::Color(255, 239, 186);
-        if (s == "vaccinated")  return sf::Color(152, 251, 152);
-        return sf::Color(240, 240, 240);
-    };
-
-    Population::Counts c = pop.countStates();
-
-    struct Entry { const char* name; int count; std::string key; };
-    Entry entries[] = {
-        {"Susceptible", c.susceptible, "susceptible"},
-        {"Infected",    c.infected,    "infected"},
-        {"Recovered",   c.recovered,   "recovered"},
-        {"Vaccinated",  c.vaccinated,  "vaccinated"}
-    };
-
-    for (const auto& e : entries) {
-        sf::RectangleShape box({20.f, 20.f});
-        box.setFillColor(stateColor(e.key));
-        box.setPosition({panelX, y});
-        window.draw(box);
-
-        if (!font.getInfo().family.empty()) {
-            std::ostringstream oss;
-            oss << e.name << " : " << e.count;
-
-            sf::Text txt(font);
-            txt.setString(oss.str());
-            txt.setCharacterSize(16);
-            txt.setFillColor(sf::Color::White);
-            txt.setPosition({panelX + 30.f, y - 3.f});
-            window.draw(txt);
-        }
-
-        y += 35.f;
-    }
-
-    if (!font.getInfo().family.empty()) {
-        y += 15.f;
-        std::ostringstream oss;
-        oss << "Step: " << step;
-
-        sf::Text stepText(font);
-        stepText.setString(oss.str());
-        stepText.setCharacterSize(18);
-        stepText.setFillColor(sf::Color::White);
-        stepText.setPosition({panelX, y});
-        window.draw(stepText);
-    }
-}
+#include "PopulationView.hpp"
+#include "PhaseTimer.hpp"
+#include "SimulationWorker.hpp"
+#include "Trace.hpp"
 
 /**
  * @brief Initializes, updates, and visualizes a member of the Population class according to our disease spread model
- * 
+ *
+ * Usage: epidemic [gridSize]
+ *
+ * The grid is shown in a fixed-size view: scroll to zoom around the pointer, drag or use the
+ * arrow keys to pan, +/- to zoom around the center and Home to fit the whole grid again.
+ * F toggles between one step every stepSeconds and stepping as fast as possible; the window
+ * is only redrawn when something changed, at most 60 times per second. The steps run on a
+ * SimulationWorker thread, so a slow step on a large grid delays the next step, not input
+ * handling or drawing.
  * @return int 
  */
-int main()
+int main(int argc, char** argv)
 {
     namespace fs = std::filesystem;
 
-    const int   gridSize      = 100;
-    const float cellSize      = 20;
-    const float gap           = 1;
+    const int   gridSize      = argc > 1 ? std::atoi(argv[1]) : 100;
+    const unsigned viewSize   = 800;
     const float stepSeconds   = 0.25;
     const int   maxSteps      = 1000;
+    if (gridSize <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [gridSize]\n";
+        return 1;
+    }
+
+    const char* tracePath = std::getenv("EPIDEMIC_TRACE");
+    if (tracePath) {
+        Tracer::global().enable();
+    }
 
     const std::string framesDir = "frames";
     std::error_code fsErr;
@@ -121,8 +67,8 @@ std::uniform_real_distribution<float> dist(0.0, 1.0);
 
 float infectionProbability = 0.75;
 
-int start = 25;
-int end   = 75;  
+int start = gridSize / 4;
+int end   = 3 * gridSize / 4;
 
 for (int i = start; i < end; ++i) {
     for (int j = start; j < end; ++j) {
@@ -139,27 +85,25 @@ for (int i = start; i < end; ++i) {
     }
     csv << "step,susceptible,infected,recovered,vaccinated\n";
 
-    {
-        Population::Counts c0 = pop.countStates();
-        csv << 0 << ','
-            << c0.susceptible << ','
-            << c0.infected    << ','
-            << c0.recovered   << ','
-            << c0.vaccinated  << '\n';
-    }
+    Population::Counts counts = pop.countStates();
+    csv << 0 << ','
+        << counts.susceptible << ','
+        << counts.infected    << ','
+        << counts.recovered   << ','
+        << counts.vaccinated  << '\n';
 
-    float gridPixelSize = gap + gridSize * (cellSize + gap);
+    //the display follows the grid through the transitions of each step, not by rereading it
+    LodPyramid pyramid(gridSize, pop.stateCodes());
 
     const unsigned legendWidth = 260;
-    unsigned windowWidth  = static_cast<unsigned>(gridPixelSize) + legendWidth;
-    unsigned windowHeight = static_cast<unsigned>(gridPixelSize);
+    unsigned windowWidth  = viewSize + legendWidth;
+    unsigned windowHeight = viewSize;
 
     sf::RenderWindow window(
         sf::VideoMode({windowWidth, windowHeight}),
         "Epidemic Simulation",
         sf::Style::Titlebar | sf::Style::Close
     );
-    window.setFramerateLimit(60);
 
     sf::Font font;
     if (!font.openFromFile("arial.ttf")) {
@@ -167,53 +111,178 @@ for (int i = start; i < end; ++i) {
                   << "Legend text will not be shown.\n";
     }
 
-    sf::Clock stepClock;
-    int  step = 0;
+    GridViewer viewer(viewSize, viewSize);
+    viewer.fit(gridSize);
+
+    //epidemic curves of the most recent steps under the legend
+    const std::int64_t cells = static_cast<std::int64_t>(gridSize) * gridSize;
+    CountHistory history(4096);
+    EpidemicChart chart({viewSize + 20.f, 280.f}, {legendWidth - 40.f, 160.f});
+    history.push(counts);
+    chart.update(history, cells);
+
+    LegendPanel legend(font, {viewSize + 20.f, 20.f});
+    legend.setCounts(counts, 0);
+    sf::Clock rateClock; // frames and steps per second, measured over half-second windows
+    int framesSinceRate = 0;
+    int stepsSinceRate = 0;
+    std::optional<sf::Vector2i> dragFrom; // pointer position while panning with the mouse
+
+    const double maxFps = 60.0;
+    FrameScheduler scheduler(stepSeconds, maxFps);
+    int  step = 0; // last step shown
     bool shouldSaveFrame = true; 
 
+    //from here on pop belongs to the worker; the display only sees its batches
+    SimulationWorker worker(pop, maxSteps);
+    std::vector<SimulationWorker::Batch> batches;
+
+    auto handleEvent = [&](const sf::Event& event) {
+        if (event.is<sf::Event::Closed>()) {
+            window.close();
+        } else if (event.is<sf::Event::FocusGained>() || event.is<sf::Event::Resized>()) {
+            scheduler.requestRedraw();
+        } else if (const auto* keyPressed =
+                       event.getIf<sf::Event::KeyPressed>()) {
+            const float panStep = 0.1f * viewSize;
+            const sf::Vector2i center(viewSize / 2, viewSize / 2);
+            switch (keyPressed->scancode) {
+                case sf::Keyboard::Scancode::Escape: window.close(); return;
+                case sf::Keyboard::Scancode::Left:   viewer.pan(panStep, 0.f); break;
+                case sf::Keyboard::Scancode::Right:  viewer.pan(-panStep, 0.f); break;
+                case sf::Keyboard::Scancode::Up:     viewer.pan(0.f, panStep); break;
+                case sf::Keyboard::Scancode::Down:   viewer.pan(0.f, -panStep); break;
+                case sf::Keyboard::Scancode::Equal:  viewer.zoomAt(2.f, center); break;
+                case sf::Keyboard::Scancode::Hyphen: viewer.zoomAt(0.5f, center); break;
+                case sf::Keyboard::Scancode::Home:   viewer.fit(gridSize); break;
+                case sf::Keyboard::Scancode::F:
+                    scheduler.setFastMode(!scheduler.fastMode());
+                    if (scheduler.fastMode()) worker.allow(true);
+                    else                      worker.pause();
+                    break;
+                default: return;
+            }
+            scheduler.requestRedraw();
+        } else if (const auto* wheel =
+                       event.getIf<sf::Event::MouseWheelScrolled>()) {
+            if (wheel->wheel == sf::Mouse::Wheel::Vertical && wheel->position.x < static_cast<int>(viewSize)) {
+                viewer.zoomAt(std::pow(1.25f, wheel->delta), wheel->position);
+                scheduler.requestRedraw();
+            }
+        } else if (const auto* pressed =
+                       event.getIf<sf::Event::MouseButtonPressed>()) {
+            if (pressed->button == sf::Mouse::Button::Left && pressed->position.x < static_cast<int>(viewSize))
+                dragFrom = pressed->position;
+        } else if (event.is<sf::Event::MouseButtonReleased>()) {
+            dragFrom.reset();
+        } else if (const auto* moved =
+                       event.getIf<sf::Event::MouseMoved>()) {
+            if (dragFrom) {
+                viewer.pan(static_cast<float>(moved->position.x - dragFrom->x),
+                           static_cast<float>(moved->position.y - dragFrom->y));
+                dragFrom = moved->position;
+                scheduler.requestRedraw();
+            }
+        }
+    };
+
     while (window.isOpen()) {
-        while (const std::optional event = window.pollEvent()) {
-            if (event->is<sf::Event::Closed>()) {
-                window.close();
-            } else if (const auto* keyPressed =
-                           event->getIf<sf::Event::KeyPressed>()) {
-                if (keyPressed->scancode == sf::Keyboard::Scancode::Escape)
-                    window.close();
+        EPIDEMIC_TRACE_SCOPE("main/frame");
+        {
+            //sleep until input arrives or the next step or frame is due; with nothing scheduled,
+            //until input arrives (waitEvent's zero timeout means no timeout). While the worker
+            //is stepping, wake at least once a frame to collect what it finished.
+            const bool working = !worker.idle();
+            std::optional<double> idle = scheduler.idleSeconds(
+                FrameScheduler::Clock::now(), !scheduler.fastMode() && !working && step < maxSteps);
+            if (working) idle = std::min(idle.value_or(1.0 / maxFps), 1.0 / maxFps);
+            std::optional<sf::Event> event;
+            if (!idle)                event = window.waitEvent();
+            else if (*idle >= 0.001)  event = window.waitEvent(sf::seconds(static_cast<float>(*idle)));
+            else                      event = window.pollEvent();
+            for (; event && window.isOpen(); event = window.pollEvent()) handleEvent(*event);
+        }
+        if (!window.isOpen()) break;
+
+        //with the worker idle before take(), every step it was allowed has been collected
+        const bool caughtUp = worker.idle();
+        batches.clear();
+        worker.take(batches);
+        if (!batches.empty()) {
+            {
+                EPIDEMIC_PHASE("main/pyramid");
+                for (const SimulationWorker::Batch& b : batches) pyramid.apply(b.transitions);
+                viewer.invalidate();
             }
+
+            EPIDEMIC_PHASE("main/csv");
+            for (const SimulationWorker::Batch& b : batches) {
+                csv << b.day << ','
+                    << b.counts.susceptible << ','
+                    << b.counts.infected    << ','
+                    << b.counts.recovered   << ','
+                    << b.counts.vaccinated  << '\n';
+                history.push(b.counts);
+            }
+            step = batches.back().day;
+            counts = batches.back().counts;
+            chart.update(history, cells);
+            legend.setCounts(counts, step);
+            stepsSinceRate += static_cast<int>(batches.size());
+            scheduler.stepped(FrameScheduler::Clock::now());
+            //a timelapse frame per step in paced mode; fast mode only shows some of the steps
+            shouldSaveFrame = !scheduler.fastMode();
         }
 
-        
-        if (step < maxSteps &&
-            stepClock.getElapsedTime().asSeconds() >= stepSeconds) {
-            pop.Update();
-            ++step;
-            stepClock.restart();
-            shouldSaveFrame = true;
-
-            Population::Counts c = pop.countStates();
-            csv << step << ','
-                << c.susceptible << ','
-                << c.infected    << ','
-                << c.recovered   << ','
-                << c.vaccinated  << '\n';
+        if (!scheduler.fastMode() && caughtUp && step < maxSteps &&
+            scheduler.stepDue(FrameScheduler::Clock::now())) {
+            worker.allow();
         }
 
-        
-        pop.draw(window, cellSize, gap); 
-        drawLegend(window, font, pop, gridPixelSize, step);
-        window.display();
+        if (!scheduler.frameDue(FrameScheduler::Clock::now())) continue;
+
+        if (const float elapsed = rateClock.getElapsedTime().asSeconds(); elapsed >= 0.5f) {
+            legend.setRates(framesSinceRate / elapsed, stepsSinceRate / elapsed);
+            framesSinceRate = stepsSinceRate = 0;
+            rateClock.restart();
+        }
+        {
+            EPIDEMIC_PHASE("main/draw");
+            window.clear(sf::Color(40, 40, 40));
+            viewer.draw(window, pyramid);
+        }
+        {
+            EPIDEMIC_PHASE("main/drawLegend");
+            legend.draw(window);
+            chart.draw(window);
+        }
+        {
+            EPIDEMIC_PHASE("main/display");
+            window.display();
+        }
+        scheduler.rendered(FrameScheduler::Clock::now());
+        ++framesSinceRate;
 
         if (shouldSaveFrame) {
-            sf::Texture texture({window.getSize()});
-            texture.update(window);
-            sf::Image screenshot = texture.copyToImage();
+            EPIDEMIC_TRACE_SCOPE("main/saveFrame");
+            sf::Image screenshot = [&] {
+                EPIDEMIC_PHASE("main/copyToImage");
+                sf::Texture texture({window.getSize()});
+                texture.update(window);
+                return texture.copyToImage();
+            }();
 
             std::ostringstream name;
             name << framesDir << "/frame_"
                  << std::setw(4) << std::setfill('0') << step
                  << ".png";
 
-            if (!screenshot.saveToFile(name.str())) {
+            bool saved;
+            {
+                EPIDEMIC_PHASE("main/saveToFile");
+                saved = screenshot.saveToFile(name.str());
+            }
+            if (!saved) {
                 std::cerr << "Failed to save frame: " << name.str() << "\n";
             } else {
                 std::cout << "Saved " << name.str() << "\n";
@@ -223,5 +292,19 @@ for (int i = start; i < end; ++i) {
         }
     }
 
+    PhaseTimings::global().report(std::cout);
+    if (const char* timingsPath = std::getenv("EPIDEMIC_TIMINGS_JSON")) {
+        if (!PhaseTimings::global().writeJson(timingsPath)) {
+            std::cerr << "Error: could not write timings to '" << timingsPath << "'.\n";
+        }
+    }
+    if (tracePath) {
+        if (Tracer::global().writeJson(tracePath)) {
+            std::cout << "Wrote trace " << tracePath << " (open in ui.perfetto.dev)\n";
+        } else {
+            std::cerr << "Error: could not write trace to '" << tracePath << "'.\n";
+        }
+    }
+
     return 0;
 }